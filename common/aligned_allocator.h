@@ -0,0 +1,80 @@
+#pragma once
+// Alocador alinhado compartilhado pelos benchmarks de streaming
+
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Alocador alinhado à linha de cache (64 bytes), para loads alinhados e stores não temporais.
+// Os elementos são criados sem inicialização: as páginas só são tocadas (e posicionadas
+// num nó NUMA) por quem escreve nelas primeiro.
+template<typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* memory = std::aligned_alloc(Alignment, bytes);
+        if (memory == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t) { std::free(memory); }
+
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template<typename T, typename U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return true; }
+
+template<typename T, typename U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return false; }
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+using FloatVector = AlignedVector<float>;
+using DoubleVector = AlignedVector<double>;
+
+// Trecho contíguo de um vetor (o C++17 não tem std::span). Converte implicitamente de
+// AlignedVector, então os kernels recebem tanto vetores inteiros quanto fatias de um buffer
+// alocado uma única vez.
+template<typename T>
+class Slice {
+public:
+    Slice(T* data, size_t size) : data_(data), size_(size) {}
+
+    template<typename Vector, typename = decltype(std::declval<Vector&>().data())>
+    Slice(Vector& vector) : data_(vector.data()), size_(vector.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) const { return data_[i]; }
+
+    // Primeiros count elementos
+    Slice first(size_t count) const { return Slice(data_, count); }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+using FloatSlice = Slice<float>;
+using ConstFloatSlice = Slice<const float>;
@@ -0,0 +1,202 @@
+#pragma once
+// Harness de medição compartilhado pelos benchmarks: execuções de aquecimento (caches,
+// TLB, páginas e frequência já estabilizados), número de repetições guiado por um tempo
+// mínimo de medição e estatísticas robustas (mínimo, mediana, p95) com intervalo de
+// confiança da mediana por bootstrap. Todos os programas gravam as medições no mesmo
+// esquema de CSV (HARNESS_CSV_HEADER); colunas novas só podem ser acrescentadas no fim.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Reamostragens do bootstrap e nível de confiança do intervalo da mediana
+const int BOOTSTRAP_RESAMPLES = 2000;
+const double CONFIDENCE_LEVEL = 0.95;
+const uint64_t BOOTSTRAP_SEED = 0x5EED5EEDull;  // Fixa: o intervalo é reprodutível para as mesmas amostras
+
+struct HarnessOptions {
+    int warmup_runs = 2;    // Execuções descartadas antes da medição
+    int min_runs = 5;       // Mínimo de execuções medidas, mesmo para kernels lentos
+    int max_runs = 1000;    // Limite para kernels muito rápidos
+    double min_time = 0.5;  // Segundos de execuções medidas antes de parar
+};
+
+// Opções usadas pelos benchmarks (--warmup e --min-time)
+inline HarnessOptions harness_options;
+
+// Estatísticas das execuções medidas de um kernel, em segundos por chamada
+struct TimingStats {
+    std::vector<double> samples;  // Em ordem de execução
+    int warmup_runs = 0;
+    int batch = 1;  // Chamadas cronometradas juntas em cada amostra
+    double min = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double p95 = 0.0;
+    double stddev = 0.0;
+    double ci_low = 0.0;   // Intervalo de confiança da mediana
+    double ci_high = 0.0;
+
+    int runs() const { return static_cast<int>(samples.size()); }
+    // Chamadas do kernel, incluindo o aquecimento (para dividir contadores de uma região)
+    int calls() const { return (warmup_runs + runs()) * batch; }
+};
+
+// Percentil p (0 a 1) de valores ordenados, com interpolação linear
+inline double sorted_percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const double position = p * (sorted.size() - 1);
+    const size_t below = static_cast<size_t>(position);
+    const size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (position - below) * (sorted[above] - sorted[below]);
+}
+
+inline double median_of(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return sorted_percentile(values, 0.5);
+}
+
+// Intervalo de confiança da mediana por bootstrap percentil
+inline void bootstrap_median_interval(const std::vector<double>& samples, double& low, double& high) {
+    std::mt19937_64 generator(BOOTSTRAP_SEED);
+    std::uniform_int_distribution<size_t> pick(0, samples.size() - 1);
+    std::vector<double> medians(BOOTSTRAP_RESAMPLES);
+    std::vector<double> resample(samples.size());
+    for (int b = 0; b < BOOTSTRAP_RESAMPLES; b++) {
+        for (double& value : resample) value = samples[pick(generator)];
+        medians[b] = median_of(resample);
+    }
+    std::sort(medians.begin(), medians.end());
+    const double tail = (1.0 - CONFIDENCE_LEVEL) / 2.0;
+    low = sorted_percentile(medians, tail);
+    high = sorted_percentile(medians, 1.0 - tail);
+}
+
+inline TimingStats summarize_samples(const std::vector<double>& samples, int warmup_runs, int batch = 1) {
+    TimingStats stats;
+    stats.samples = samples;
+    stats.warmup_runs = warmup_runs;
+    stats.batch = batch;
+    if (samples.empty()) return stats;
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    stats.min = sorted.front();
+    stats.median = sorted_percentile(sorted, 0.5);
+    stats.p95 = sorted_percentile(sorted, 0.95);
+    stats.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    double squares = 0.0;
+    for (double value : sorted) squares += (value - stats.mean) * (value - stats.mean);
+    stats.stddev = sorted.size() > 1 ? std::sqrt(squares / (sorted.size() - 1)) : 0.0;
+    bootstrap_median_interval(samples, stats.ci_low, stats.ci_high);
+    return stats;
+}
+
+// Executar func com aquecimento e repetir até min_runs execuções e min_time segundos
+// medidos (ou max_runs execuções). Kernels curtos demais para o relógio são chamados
+// batch vezes por amostra, e a amostra guarda o tempo por chamada.
+template<typename Func>
+TimingStats run_harness(Func func, const HarnessOptions& options = harness_options, int batch = 1) {
+    for (int i = 0; i < options.warmup_runs * batch; i++) func();
+
+    std::vector<double> samples;
+    double measured = 0.0;
+    while (static_cast<int>(samples.size()) < options.max_runs &&
+           (static_cast<int>(samples.size()) < options.min_runs || measured < options.min_time)) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < batch; i++) func();
+        auto end = std::chrono::high_resolution_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        samples.push_back(seconds / batch);
+        measured += seconds;
+    }
+    return summarize_samples(samples, options.warmup_runs, batch);
+}
+
+// Converter o valor de uma opção exigindo que o texto inteiro seja um número do tipo T
+// ("10x", "" ou "-1" para tipos sem sinal são rejeitados). Lança std::invalid_argument ou
+// std::out_of_range com a opção e o valor recebido na mensagem.
+template<typename T>
+T parse_number(const std::string& option, const char* text) {
+    T value{};
+    const char* end = text + std::strlen(text);
+    const auto [last, error] = std::from_chars(text, end, value);
+    if (error == std::errc::result_out_of_range) {
+        throw std::out_of_range("Valor fora do intervalo para " + option + ": '" + text + "'");
+    }
+    if (error != std::errc() || last != end) {
+        throw std::invalid_argument("Valor inválido para " + option + ": '" + text + "'");
+    }
+    return value;
+}
+
+// Ler --warmup N e --min-time S; devolve true se argv[i] era uma dessas opções
+// (valores malformados lançam a exceção de parse_number)
+inline bool parse_harness_option(int argc, char* argv[], int& i) {
+    const std::string arg = argv[i];
+    if (arg == "--warmup" && i + 1 < argc) {
+        harness_options.warmup_runs = std::max(0, parse_number<int>(arg, argv[++i]));
+        return true;
+    }
+    if (arg == "--min-time" && i + 1 < argc) {
+        harness_options.min_time = std::max(0.0, parse_number<double>(arg, argv[++i]));
+        return true;
+    }
+    return false;
+}
+
+const char* const HARNESS_USAGE =
+    "  --warmup N      execuções de aquecimento descartadas por kernel (padrão 2)\n"
+    "  --min-time S    segundos mínimos de execuções medidas por kernel (padrão 0.5)\n";
+
+// "Serial: mediana 0.12 s [IC95% 0.119, 0.121], min 0.118 s, p95 0.125 s, 12 execuções"
+inline void print_timing_stats(const std::string& name, const TimingStats& stats) {
+    std::cout << name << ": mediana " << stats.median << " s [IC" << CONFIDENCE_LEVEL * 100 << "% "
+              << stats.ci_low << ", " << stats.ci_high << "], min " << stats.min << " s, p95 " << stats.p95
+              << " s, " << stats.runs() << " execuções" << std::endl;
+}
+
+const char* const HARNESS_CSV_HEADER =
+    "Programa,Experimento,Variante,Elementos,Threads,Aquecimento,Execuções,Min(s),Mediana(s),Média(s),"
+    "P95(s),DesvioPadrão(s),ICMedianaInf(s),ICMedianaSup(s),Lote";
+
+// CSV de medições no esquema comum: uma linha por (experimento, variante, tamanho)
+class HarnessCsv {
+public:
+    HarnessCsv(const std::string& path, const std::string& program) : file_(path), program_(program) {
+        file_ << HARNESS_CSV_HEADER << "\n";
+    }
+
+    void add(const std::string& experiment, const std::string& variant, size_t elements, int num_threads,
+             const TimingStats& stats) {
+        file_ << program_ << "," << experiment << "," << variant << "," << elements << "," << num_threads << ","
+              << stats.warmup_runs << "," << stats.runs() << "," << stats.min << "," << stats.median << ","
+              << stats.mean << "," << stats.p95 << "," << stats.stddev << "," << stats.ci_low << ","
+              << stats.ci_high << "," << stats.batch << "\n";
+    }
+
+private:
+    std::ofstream file_;
+    std::string program_;
+};
+
+// Medir func com o harness e registrar a medição em timings
+template<typename Func>
+TimingStats measure_stats(HarnessCsv& timings, const std::string& experiment, const std::string& variant,
+                          size_t elements, int num_threads, Func func,
+                          const HarnessOptions& options = harness_options, int batch = 1) {
+    const TimingStats stats = run_harness(func, options, batch);
+    timings.add(experiment, variant, elements, num_threads, stats);
+    return stats;
+}
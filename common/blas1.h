@@ -0,0 +1,324 @@
+#pragma once
+// Operações BLAS-1 fundidas com expression templates. Uma cadeia como
+//
+//     fuse(assign(y, a * x + y), assign(z, b * y + z)).run_reduce(sum_squares(z), n, threads)
+//
+// (com x = vec(x_data) etc.) é executada numa única passada: cada thread percorre o seu
+// bloco de for_each_thread_chunk em pedaços que cabem na L1 e aplica todas as etapas a cada
+// pedaço antes de seguir, então y é relido da cache pela segunda etapa e pela redução em
+// vez de voltar à DRAM.
+// Produto seguido de soma/subtração vira FMA, como nos kernels SAXPY.
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "numa.h"
+
+namespace blas1 {
+
+// Elementos por pedaço: com até 4 vetores por etapa, 4 x 4 KiB cabem na L1
+const size_t FUSED_BLOCK_SIZE = 1024;
+
+template<typename Derived>
+struct Expr {
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+// Referência a um vetor de float (não possui os dados)
+struct Vector : Expr<Vector> {
+    float* data;
+
+    explicit Vector(float* data) : data(data) {}
+
+    __m256 load(size_t i) const { return _mm256_loadu_ps(data + i); }
+    float at(size_t i) const { return data[i]; }
+
+    template<typename Func>
+    void for_each_vector(Func func) const { func(data); }
+};
+
+template<typename Container>
+Vector vec(Container& container) {
+    return Vector(container.data());
+}
+
+struct Scalar : Expr<Scalar> {
+    float value;
+
+    explicit Scalar(float value) : value(value) {}
+
+    __m256 load(size_t) const { return _mm256_set1_ps(value); }
+    float at(size_t) const { return value; }
+
+    template<typename Func>
+    void for_each_vector(Func) const {}
+};
+
+template<typename L, typename R>
+struct Product : Expr<Product<L, R>> {
+    L left;
+    R right;
+
+    Product(const L& left, const R& right) : left(left), right(right) {}
+
+    __m256 load(size_t i) const { return _mm256_mul_ps(left.load(i), right.load(i)); }
+    float at(size_t i) const { return left.at(i) * right.at(i); }
+
+    template<typename Func>
+    void for_each_vector(Func func) const {
+        left.for_each_vector(func);
+        right.for_each_vector(func);
+    }
+};
+
+template<typename T>
+struct is_product : std::false_type {};
+
+template<typename L, typename R>
+struct is_product<Product<L, R>> : std::true_type {};
+
+template<typename L, typename R>
+struct Sum : Expr<Sum<L, R>> {
+    L left;
+    R right;
+
+    Sum(const L& left, const R& right) : left(left), right(right) {}
+
+    __m256 load(size_t i) const {
+        if constexpr (is_product<L>::value) {
+            return _mm256_fmadd_ps(left.left.load(i), left.right.load(i), right.load(i));
+        } else if constexpr (is_product<R>::value) {
+            return _mm256_fmadd_ps(right.left.load(i), right.right.load(i), left.load(i));
+        } else {
+            return _mm256_add_ps(left.load(i), right.load(i));
+        }
+    }
+
+    float at(size_t i) const {
+        if constexpr (is_product<L>::value) {
+            return std::fma(left.left.at(i), left.right.at(i), right.at(i));
+        } else if constexpr (is_product<R>::value) {
+            return std::fma(right.left.at(i), right.right.at(i), left.at(i));
+        } else {
+            return left.at(i) + right.at(i);
+        }
+    }
+
+    template<typename Func>
+    void for_each_vector(Func func) const {
+        left.for_each_vector(func);
+        right.for_each_vector(func);
+    }
+};
+
+template<typename L, typename R>
+struct Difference : Expr<Difference<L, R>> {
+    L left;
+    R right;
+
+    Difference(const L& left, const R& right) : left(left), right(right) {}
+
+    __m256 load(size_t i) const {
+        if constexpr (is_product<L>::value) {
+            return _mm256_fmsub_ps(left.left.load(i), left.right.load(i), right.load(i));
+        } else if constexpr (is_product<R>::value) {
+            return _mm256_fnmadd_ps(right.left.load(i), right.right.load(i), left.load(i));
+        } else {
+            return _mm256_sub_ps(left.load(i), right.load(i));
+        }
+    }
+
+    float at(size_t i) const {
+        if constexpr (is_product<L>::value) {
+            return std::fma(left.left.at(i), left.right.at(i), -right.at(i));
+        } else if constexpr (is_product<R>::value) {
+            return std::fma(-right.left.at(i), right.right.at(i), left.at(i));
+        } else {
+            return left.at(i) - right.at(i);
+        }
+    }
+
+    template<typename Func>
+    void for_each_vector(Func func) const {
+        left.for_each_vector(func);
+        right.for_each_vector(func);
+    }
+};
+
+template<typename L, typename R>
+Sum<L, R> operator+(const Expr<L>& left, const Expr<R>& right) {
+    return Sum<L, R>(left.self(), right.self());
+}
+
+template<typename L, typename R>
+Difference<L, R> operator-(const Expr<L>& left, const Expr<R>& right) {
+    return Difference<L, R>(left.self(), right.self());
+}
+
+template<typename L, typename R>
+Product<L, R> operator*(const Expr<L>& left, const Expr<R>& right) {
+    return Product<L, R>(left.self(), right.self());
+}
+
+template<typename R>
+Product<Scalar, R> operator*(float left, const Expr<R>& right) {
+    return Product<Scalar, R>(Scalar(left), right.self());
+}
+
+template<typename L>
+Product<L, Scalar> operator*(const Expr<L>& left, float right) {
+    return Product<L, Scalar>(left.self(), Scalar(right));
+}
+
+// Etapa elemento a elemento: target[i] = expr(i). target pode aparecer em expr
+// (y = a * x + y), desde que só na mesma posição.
+template<typename E>
+struct Assignment {
+    Vector target;
+    E expr;
+
+    void run(size_t begin, size_t end) const {
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            _mm256_storeu_ps(target.data + i, expr.load(i));
+        }
+        for (; i < end; ++i) {
+            target.data[i] = expr.at(i);
+        }
+    }
+
+    template<typename Func>
+    void for_each_read(Func func) const { expr.for_each_vector(func); }
+
+    template<typename Func>
+    void for_each_write(Func func) const { func(target.data); }
+};
+
+template<typename E>
+Assignment<E> assign(Vector target, const Expr<E>& expr) {
+    return Assignment<E>{target, expr.self()};
+}
+
+// Redução final: soma de left(i) * right(i). Cada pedaço é acumulado em float (dois
+// acumuladores) e somado em double à parcial da thread.
+template<typename L, typename R>
+struct DotReduction {
+    L left;
+    R right;
+
+    double run(size_t begin, size_t end) const {
+        __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+        size_t i = begin;
+        for (; i + 16 <= end; i += 16) {
+            sum0 = _mm256_fmadd_ps(left.load(i), right.load(i), sum0);
+            sum1 = _mm256_fmadd_ps(left.load(i + 8), right.load(i + 8), sum1);
+        }
+        for (; i + 8 <= end; i += 8) {
+            sum0 = _mm256_fmadd_ps(left.load(i), right.load(i), sum0);
+        }
+
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, _mm256_add_ps(sum0, sum1));
+        double result = 0.0;
+        for (float lane : lanes) result += lane;
+        for (; i < end; ++i) {
+            result += static_cast<double>(left.at(i)) * right.at(i);
+        }
+        return result;
+    }
+
+    template<typename Func>
+    void for_each_read(Func func) const {
+        left.for_each_vector(func);
+        right.for_each_vector(func);
+    }
+};
+
+template<typename L, typename R>
+DotReduction<L, R> dot(const Expr<L>& left, const Expr<R>& right) {
+    return DotReduction<L, R>{left.self(), right.self()};
+}
+
+template<typename E>
+DotReduction<E, E> sum_squares(const Expr<E>& expr) {
+    return DotReduction<E, E>{expr.self(), expr.self()};
+}
+
+struct NoReduction {
+    double run(size_t, size_t) const { return 0.0; }
+
+    template<typename Func>
+    void for_each_read(Func) const {}
+};
+
+// Cadeia de etapas executadas juntas, pedaço a pedaço
+template<typename... Stages>
+class FusedChain {
+public:
+    explicit FusedChain(const Stages&... stages) : stages_(stages...) {}
+
+    void run(size_t size, int num_threads) const {
+        run_reduce(NoReduction{}, size, num_threads);
+    }
+
+    // Executar as etapas e devolver a redução sobre o resultado. As parciais das threads
+    // são somadas na ordem dos blocos, então o valor não depende do escalonamento.
+    template<typename Reduction>
+    double run_reduce(const Reduction& reduction, size_t size, int num_threads) const {
+        size_t first_start, chunk_size;
+        thread_chunk(size, num_threads, 0, first_start, chunk_size);
+        if (chunk_size == 0) return 0.0;
+
+        std::vector<double> partials(num_threads, 0.0);
+        for_each_thread_chunk(size, num_threads, [&](size_t start, size_t end) {
+            double partial = 0.0;
+            for (size_t block = start; block < end; block += FUSED_BLOCK_SIZE) {
+                const size_t block_end = std::min(block + FUSED_BLOCK_SIZE, end);
+                std::apply([&](const auto&... stage) { (stage.run(block, block_end), ...); }, stages_);
+                partial += reduction.run(block, block_end);
+            }
+            partials[start / chunk_size] = partial;
+        });
+        return std::accumulate(partials.begin(), partials.end(), 0.0);
+    }
+
+    // Bytes trocados com a memória, contando cada vetor uma vez: lido se for usado antes
+    // de ser escrito na cadeia, escrito se for destino de alguma etapa
+    template<typename Reduction = NoReduction>
+    size_t traffic_bytes(size_t size, const Reduction& reduction = Reduction{}) const {
+        std::vector<const float*> read, written;
+        auto note_read = [&](const float* data) {
+            if (std::find(written.begin(), written.end(), data) == written.end() &&
+                std::find(read.begin(), read.end(), data) == read.end()) {
+                read.push_back(data);
+            }
+        };
+        auto note_write = [&](const float* data) {
+            if (std::find(written.begin(), written.end(), data) == written.end()) {
+                written.push_back(data);
+            }
+        };
+        std::apply([&](const auto&... stage) {
+            ((stage.for_each_read(note_read), stage.for_each_write(note_write)), ...);
+        }, stages_);
+        reduction.for_each_read(note_read);
+        return (read.size() + written.size()) * size * sizeof(float);
+    }
+
+private:
+    std::tuple<Stages...> stages_;
+};
+
+template<typename... Stages>
+FusedChain<Stages...> fuse(const Stages&... stages) {
+    return FusedChain<Stages...>(stages...);
+}
+
+} // namespace blas1
@@ -0,0 +1,101 @@
+#pragma once
+// Armazenamento em 16 bits (IEEE half e bfloat16) para kernels limitados por bandwidth:
+// os dados ficam na memória com metade dos bytes e são convertidos para float nos
+// registradores, onde todas as contas são feitas em fp32. O fp16 usa as instruções F16C
+// (vcvtph2ps/vcvtps2ph); o bf16 é a metade de cima do float, convertido com shifts.
+
+#include <immintrin.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "numa.h"
+
+// IEEE 754 binary16: 5 bits de expoente, 10 de mantissa (máximo 65504)
+struct Float16 {
+    uint16_t bits;
+
+    static constexpr const char* name = "fp16";
+    static constexpr float epsilon = 0x1p-10f;  // Distância de 1 ao próximo valor
+};
+
+// bfloat16: o expoente do float (mesma faixa) e 7 bits de mantissa
+struct BFloat16 {
+    uint16_t bits;
+
+    static constexpr const char* name = "bf16";
+    static constexpr float epsilon = 0x1p-7f;
+};
+
+using Float16Vector = std::vector<Float16, AlignedAllocator<Float16>>;
+using BFloat16Vector = std::vector<BFloat16, AlignedAllocator<BFloat16>>;
+
+inline float load_float(const Float16* p) {
+    return _cvtsh_ss(p->bits);
+}
+
+inline void store_float(Float16* p, float value) {
+    p->bits = _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+}
+
+inline float load_float(const BFloat16* p) {
+    const uint32_t bits = static_cast<uint32_t>(p->bits) << 16;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Arredondamento para o par mais próximo; sem tratamento de NaN (os dados são finitos)
+inline void store_float(BFloat16* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    p->bits = static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+}
+
+// 8 valores consecutivos convertidos para float
+inline __m256 load_float8(const Float16* p) {
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline void store_float8(Float16* p, __m256 values) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+}
+
+inline __m256 load_float8(const BFloat16* p) {
+    const __m256i widened = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(widened, 16));
+}
+
+// Mesmo arredondamento de store_float; os 8 resultados de 32 bits (< 2^16) são
+// empacotados com saturação sem sinal, que não altera nenhum deles
+inline void store_float8(BFloat16* p, __m256 values) {
+    const __m256i bits = _mm256_castps_si256(values);
+    const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    const __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), odd));
+    const __m256i upper = _mm256_srli_epi32(rounded, 16);
+    const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(upper), _mm256_extracti128_si256(upper, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), packed);
+}
+
+// Converter source para 16 bits em paralelo, com o particionamento (e o first-touch) das
+// threads de cálculo
+template<typename Storage>
+void narrow_floats(Slice<const float> source, Slice<Storage> destination, int num_threads) {
+    for_each_thread_chunk(source.size(), num_threads, [&](size_t start, size_t end) {
+        size_t i = start;
+        for (; i + 8 <= end; i += 8) store_float8(&destination[i], _mm256_loadu_ps(&source[i]));
+        for (; i < end; ++i) store_float(&destination[i], source[i]);
+    });
+}
+
+// Converter de volta para float (exato: todo fp16 e bf16 é representável em float)
+template<typename Storage>
+void widen_floats(Slice<const Storage> source, Slice<float> destination, int num_threads) {
+    for_each_thread_chunk(source.size(), num_threads, [&](size_t start, size_t end) {
+        size_t i = start;
+        for (; i + 8 <= end; i += 8) _mm256_storeu_ps(&destination[i], load_float8(&source[i]));
+        for (; i < end; ++i) destination[i] = load_float(&source[i]);
+    });
+}
@@ -0,0 +1,73 @@
+// Sistema de tarefas mínimo para o código gerado pelo ISPC (launch/sync).
+// Cada launch distribui os índices de tarefa entre hardware_concurrency() threads;
+// ISPCSync espera todas as threads do grupo e libera a memória dos argumentos.
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+typedef void (*ISPCTaskFunc)(void* data, int thread_index, int thread_count,
+                             int task_index, int task_count,
+                             int task_index0, int task_index1, int task_index2,
+                             int task_count0, int task_count1, int task_count2);
+
+namespace {
+
+// Tarefas lançadas por uma função ISPC até o próximo sync
+struct TaskGroup {
+    std::vector<void*> allocations;
+    std::vector<std::thread> threads;
+};
+
+TaskGroup* get_group(void** handle) {
+    if (*handle == nullptr) {
+        *handle = new TaskGroup;
+    }
+    return static_cast<TaskGroup*>(*handle);
+}
+
+} // namespace
+
+extern "C" {
+
+void* ISPCAlloc(void** handle, int64_t size, int32_t alignment) {
+    TaskGroup* group = get_group(handle);
+    size_t rounded = (static_cast<size_t>(size) + alignment - 1) / alignment * alignment;
+    void* memory = std::aligned_alloc(alignment, rounded);
+    group->allocations.push_back(memory);
+    return memory;
+}
+
+void ISPCLaunch(void** handle, void* func, void* data, int count0, int count1, int count2) {
+    TaskGroup* group = get_group(handle);
+    const int task_count = count0 * count1 * count2;
+    const int thread_count = std::max(1, std::min<int>(task_count, std::thread::hardware_concurrency()));
+    auto next = std::make_shared<std::atomic<int>>(0);
+
+    for (int t = 0; t < thread_count; t++) {
+        group->threads.emplace_back([=]() {
+            ISPCTaskFunc task = reinterpret_cast<ISPCTaskFunc>(func);
+            for (int i = next->fetch_add(1); i < task_count; i = next->fetch_add(1)) {
+                task(data, t, thread_count, i, task_count,
+                     i % count0, (i / count0) % count1, i / (count0 * count1),
+                     count0, count1, count2);
+            }
+        });
+    }
+}
+
+void ISPCSync(void* handle) {
+    TaskGroup* group = static_cast<TaskGroup*>(handle);
+    for (auto& thread : group->threads) {
+        thread.join();
+    }
+    for (void* memory : group->allocations) {
+        std::free(memory);
+    }
+    delete group;
+}
+
+}
@@ -0,0 +1,234 @@
+#pragma once
+// Topologia NUMA, afinidade de threads e inicialização paralela (first-touch)
+// compartilhadas pelos benchmarks de streaming. Sem /sys/devices/system/node
+// (ou em máquinas com um só nó) tudo se reduz a um único nó com as CPUs permitidas.
+
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+// CPUs de cada nó NUMA que este processo pode usar
+struct NumaTopology {
+    std::vector<int> node_ids;
+    std::vector<std::vector<int>> node_cpus;
+
+    int num_nodes() const { return static_cast<int>(node_cpus.size()); }
+};
+
+// Ler uma lista de CPUs no formato do kernel ("0-3,8-11")
+inline std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.substr(0, dash).c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.substr(dash + 1).c_str());
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// Escrever uma lista de CPUs sem vírgulas (para colunas de CSV): "0-3+8-11"
+inline std::string format_cpu_list(const std::vector<int>& cpus) {
+    std::string result;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+        if (!result.empty()) result += "+";
+        result += std::to_string(cpus[i]);
+        if (j > i) result += "-" + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return result;
+}
+
+inline NumaTopology read_numa_topology() {
+    std::vector<int> allowed;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) allowed.push_back(cpu);
+        }
+    }
+    if (allowed.empty()) {
+        for (int cpu = 0; cpu < static_cast<int>(std::thread::hardware_concurrency()); cpu++) {
+            allowed.push_back(cpu);
+        }
+    }
+
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) continue;
+
+            std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+
+            std::vector<int> cpus;
+            for (int cpu : parse_cpu_list(list)) {
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) cpus.push_back(cpu);
+            }
+            if (!cpus.empty()) nodes.emplace_back(std::atoi(name.c_str() + 4), cpus);
+        }
+        closedir(dir);
+    }
+
+    NumaTopology topology;
+    if (nodes.empty()) {
+        nodes.emplace_back(0, allowed);
+    }
+    std::sort(nodes.begin(), nodes.end());
+    for (auto& node : nodes) {
+        topology.node_ids.push_back(node.first);
+        topology.node_cpus.push_back(node.second);
+    }
+    return topology;
+}
+
+inline const NumaTopology& numa_topology() {
+    static const NumaTopology topology = read_numa_topology();
+    return topology;
+}
+
+// Descrição da topologia sem vírgulas: "node0:0-15 node1:16-31"
+inline std::string describe_numa_topology(const NumaTopology& topology) {
+    std::string result;
+    for (int i = 0; i < topology.num_nodes(); i++) {
+        if (i > 0) result += " ";
+        result += "node" + std::to_string(topology.node_ids[i]) + ":" + format_cpu_list(topology.node_cpus[i]);
+    }
+    return result;
+}
+
+// Fixar as threads de trabalho em CPUs (--pin)
+inline bool numa_pin_threads = false;
+
+// Colunas de topologia acrescentadas às linhas dos CSVs
+const char* const NUMA_CSV_HEADER = ",NumaNodes,NumaTopology,Pinned";
+
+inline std::string numa_csv_columns() {
+    const NumaTopology& topology = numa_topology();
+    return "," + std::to_string(topology.num_nodes()) + "," + describe_numa_topology(topology) + "," +
+           (numa_pin_threads ? "1" : "0");
+}
+
+// Bloco [start, end) da thread i quando size elementos são divididos entre num_threads.
+// Os blocos têm múltiplos de 16 elementos, para que cada um comece numa linha de cache.
+inline void thread_chunk(size_t size, int num_threads, int i, size_t& start, size_t& end) {
+    const size_t chunk_size = ((size + num_threads - 1) / num_threads + 15) / 16 * 16;
+    start = std::min(i * chunk_size, size);
+    end = std::min(start + chunk_size, size);
+}
+
+// CPU da thread i: as threads ocupam os nós em blocos contíguos, na mesma ordem
+// dos blocos de dados, e percorrem as CPUs de cada nó
+inline int cpu_for_thread(const NumaTopology& topology, int thread, int num_threads) {
+    const int nodes = topology.num_nodes();
+    const int node = static_cast<int>(static_cast<long>(thread) * nodes / num_threads);
+    const int first_thread = static_cast<int>((static_cast<long>(node) * num_threads + nodes - 1) / nodes);
+    const std::vector<int>& cpus = topology.node_cpus[node];
+    return cpus[(thread - first_thread) % cpus.size()];
+}
+
+// Chamado antes de cada bloco de trabalho; sem --pin não faz nada. Os workers do pool
+// são persistentes, então a afinidade só é alterada quando a CPU de destino muda.
+inline void place_worker_thread(int thread, int num_threads) {
+    if (!numa_pin_threads) return;
+
+    const int cpu = cpu_for_thread(numa_topology(), thread, num_threads);
+    thread_local int pinned_cpu = -1;
+    if (cpu == pinned_cpu) return;
+    pinned_cpu = cpu;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true)) {
+            std::cerr << "Aviso: não foi possível fixar a afinidade das threads" << std::endl;
+        }
+    }
+}
+
+// Executar func(start, end) no pool compartilhado com o particionamento dos kernels.
+// O bloco i é sempre processado pelo worker i, o mesmo que fez o first-touch dele.
+template<typename Func>
+void for_each_thread_chunk(size_t size, int num_threads, Func func) {
+    size_t chunk_start, chunk_size;
+    thread_chunk(size, num_threads, 0, chunk_start, chunk_size);
+    if (chunk_size == 0) return;
+    shared_thread_pool(num_threads).parallel_for(size, chunk_size, [&](size_t start, size_t end) {
+        place_worker_thread(static_cast<int>(start / chunk_size), num_threads);
+        func(start, end);
+    });
+}
+
+// Mesmo particionamento, criando as threads a cada chamada (para comparação com o pool)
+template<typename Func>
+void for_each_thread_chunk_spawn(size_t size, int num_threads, Func func) {
+    size_t chunk_start, chunk_size;
+    thread_chunk(size, num_threads, 0, chunk_start, chunk_size);
+    if (chunk_size == 0) return;
+    spawn_parallel_for(size, chunk_size, num_threads, [&](size_t start, size_t end) {
+        place_worker_thread(static_cast<int>(start / chunk_size), num_threads);
+        func(start, end);
+    });
+}
+
+// Tocar as páginas em paralelo para que cada uma fique no nó da thread que vai processá-la
+template<typename Vector>
+void first_touch(Vector& data, int num_threads) {
+    for_each_thread_chunk(data.size(), num_threads, [&](size_t start, size_t end) {
+        std::fill(data.begin() + start, data.begin() + end, typename Vector::value_type());
+    });
+}
+
+// Vetor novo com as páginas já posicionadas por first_touch
+template<typename Vector>
+Vector first_touch_allocate(size_t size, int num_threads) {
+    Vector data(size);
+    first_touch(data, num_threads);
+    return data;
+}
+
+// Cópia cujas páginas são tocadas primeiro pelas threads de cada bloco
+template<typename Vector>
+Vector first_touch_copy(const Vector& source, int num_threads) {
+    Vector copy(source.size());
+    for_each_thread_chunk(source.size(), num_threads, [&](size_t start, size_t end) {
+        std::copy(source.begin() + start, source.begin() + end, copy.begin() + start);
+    });
+    return copy;
+}
+
+// Cópia convertida elemento a elemento para o tipo de Result (float -> double, por
+// exemplo), tocada pelas threads de cada bloco
+template<typename Result, typename Vector>
+Result first_touch_convert(const Vector& source, int num_threads) {
+    Result copy(source.size());
+    for_each_thread_chunk(source.size(), num_threads, [&](size_t start, size_t end) {
+        std::copy(source.begin() + start, source.begin() + end, copy.begin() + start);
+    });
+    return copy;
+}
@@ -0,0 +1,285 @@
+#pragma once
+// Contadores de hardware (perf_event_open) em torno das regiões medidas: ciclos,
+// instruções, misses de LLC, misses de dTLB e branches mal previstos, só em modo usuário.
+// Cada thread que executa kernels (a principal e os workers do pool) abre o seu próprio
+// grupo de contadores; uma região soma a diferença de todos os grupos abertos. Sem PMU
+// (máquinas virtuais) ou com perf_event_paranoid restrito, os valores ficam marcados como
+// indisponíveis e os benchmarks seguem normalmente.
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+struct PerfEventSpec {
+    const char* column;  // Nome da coluna no CSV
+    uint32_t type;
+    uint64_t config;
+};
+
+const int PERF_EVENT_COUNT = 5;
+const int PERF_CYCLES = 0;
+const int PERF_INSTRUCTIONS = 1;
+const int PERF_LLC_MISSES = 2;
+const int PERF_DTLB_MISSES = 3;
+const int PERF_BRANCH_MISSES = 4;
+
+// LLC misses usa o evento genérico de cache misses, que o kernel mapeia para a LLC
+inline const PerfEventSpec PERF_EVENTS[PERF_EVENT_COUNT] = {
+    {"Ciclos", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"Instruções", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"LLCMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"DTLBMisses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {"BranchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+const char* const PERF_UNAVAILABLE = "n/d";
+
+// Contagens de uma região (por chamada), com a disponibilidade de cada evento
+struct PerfSample {
+    bool available[PERF_EVENT_COUNT] = {};
+    double values[PERF_EVENT_COUNT] = {};
+
+    bool any() const { return std::any_of(available, available + PERF_EVENT_COUNT, [](bool a) { return a; }); }
+
+    bool has_ipc() const { return available[PERF_CYCLES] && available[PERF_INSTRUCTIONS] && values[PERF_CYCLES] > 0; }
+    double ipc() const { return has_ipc() ? values[PERF_INSTRUCTIONS] / values[PERF_CYCLES] : 0.0; }
+};
+
+// Leitura acumulada de um grupo: tempo habilitado/em execução (para a multiplexação) e valores
+struct PerfReading {
+    uint64_t enabled = 0;
+    uint64_t running = 0;
+    uint64_t values[PERF_EVENT_COUNT] = {};
+};
+
+// Grupo de contadores da thread que o criou
+class PerfGroup {
+public:
+    PerfGroup();
+    ~PerfGroup();
+
+    PerfGroup(const PerfGroup&) = delete;
+    PerfGroup& operator=(const PerfGroup&) = delete;
+
+    bool opened(int event) const { return fds_[event] >= 0; }
+    bool read(PerfReading& reading) const;
+
+private:
+    int fds_[PERF_EVENT_COUNT];
+    int leader_ = -1;
+    int slots_[PERF_EVENT_COUNT];  // Posição de cada evento na leitura do grupo
+    int num_opened_ = 0;
+};
+
+// Grupos abertos no processo. Nunca é destruído: workers do pool ainda podem fechar os
+// seus grupos durante a destruição dos objetos estáticos.
+struct PerfRegistry {
+    std::mutex mutex;
+    std::vector<PerfGroup*> groups;
+    std::atomic<bool> warned{false};
+};
+
+inline PerfRegistry& perf_registry() {
+    static PerfRegistry* registry = new PerfRegistry;
+    return *registry;
+}
+
+inline int perf_event_paranoid() {
+    std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+    int level = -1;
+    file >> level;
+    return level;
+}
+
+inline PerfGroup::PerfGroup() {
+    for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+        fds_[event] = -1;
+        slots_[event] = -1;
+
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_EVENTS[event].type;
+        attr.config = PERF_EVENTS[event].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // pid 0, cpu -1: a thread atual, em qualquer CPU
+        const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+        if (fd < 0) {
+            // Sem o líder (ciclos) o grupo não existe; os outros eventos são opcionais
+            if (!perf_registry().warned.exchange(true)) {
+                std::cerr << "Aviso: contador " << PERF_EVENTS[event].column << " indisponível ("
+                          << std::strerror(errno) << ", perf_event_paranoid=" << perf_event_paranoid()
+                          << "); colunas sem contador ficam como " << PERF_UNAVAILABLE << std::endl;
+            }
+            if (leader_ < 0) break;
+            continue;
+        }
+        if (leader_ < 0) leader_ = fd;
+        fds_[event] = fd;
+        slots_[event] = num_opened_++;
+    }
+
+    std::lock_guard<std::mutex> lock(perf_registry().mutex);
+    perf_registry().groups.push_back(this);
+}
+
+inline PerfGroup::~PerfGroup() {
+    {
+        std::lock_guard<std::mutex> lock(perf_registry().mutex);
+        auto& groups = perf_registry().groups;
+        groups.erase(std::remove(groups.begin(), groups.end(), this), groups.end());
+    }
+    for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+        if (fds_[event] >= 0) close(fds_[event]);
+    }
+}
+
+inline bool PerfGroup::read(PerfReading& reading) const {
+    if (leader_ < 0) return false;
+    uint64_t buffer[3 + PERF_EVENT_COUNT];
+    const ssize_t expected = static_cast<ssize_t>((3 + num_opened_) * sizeof(uint64_t));
+    if (::read(leader_, buffer, sizeof(buffer)) != expected) return false;
+
+    reading.enabled = buffer[1];
+    reading.running = buffer[2];
+    for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+        reading.values[event] = slots_[event] >= 0 ? buffer[3 + slots_[event]] : 0;
+    }
+    return true;
+}
+
+// Grupo da thread atual, aberto na primeira chamada e fechado quando a thread termina
+inline PerfGroup& thread_perf_group() {
+    thread_local PerfGroup group;
+    return group;
+}
+
+// Região medida: abre o grupo da thread atual e, com num_threads > 0, os dos workers do
+// pool de num_threads (os mesmos que executarão o kernel), e guarda a leitura inicial de
+// todos os grupos. Threads criadas a cada chamada (as versões spawn e as tarefas do ISPC)
+// não são contadas.
+class PerfRegion {
+public:
+    explicit PerfRegion(int num_threads = 0) {
+        thread_perf_group();
+        if (num_threads > 0) {
+            shared_thread_pool(num_threads).parallel_for(num_threads, 1, [](size_t, size_t) {
+                thread_perf_group();
+            });
+        }
+        start_ = snapshot();
+    }
+
+    // Diferença desde o início, dividida por calls (repetições do kernel na região).
+    // Cada grupo é escalado por tempo habilitado / em execução se o kernel multiplexou os
+    // contadores; um evento só é disponível se todos os grupos o contaram.
+    PerfSample stop(int calls = 1) const {
+        const auto end = snapshot();
+        PerfSample sample;
+        bool counted[PERF_EVENT_COUNT];
+        std::fill(counted, counted + PERF_EVENT_COUNT, !end.empty());
+
+        for (const auto& [group, last] : end) {
+            PerfReading first;
+            for (const auto& [start_group, reading] : start_) {
+                if (start_group == group) first = reading;
+            }
+            const uint64_t enabled = last.enabled - first.enabled;
+            const uint64_t running = last.running - first.running;
+            const double scale = running > 0 ? static_cast<double>(enabled) / running : 0.0;
+            for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+                if (!group->opened(event) || (enabled > 0 && running == 0)) {
+                    counted[event] = false;
+                    continue;
+                }
+                sample.values[event] += (last.values[event] - first.values[event]) * scale / calls;
+            }
+        }
+        for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+            sample.available[event] = counted[event];
+            if (!counted[event]) sample.values[event] = 0.0;
+        }
+        return sample;
+    }
+
+private:
+    static std::vector<std::pair<const PerfGroup*, PerfReading>> snapshot() {
+        std::vector<std::pair<const PerfGroup*, PerfReading>> readings;
+        std::lock_guard<std::mutex> lock(perf_registry().mutex);
+        for (const PerfGroup* group : perf_registry().groups) {
+            PerfReading reading;
+            if (group->read(reading)) readings.emplace_back(group, reading);
+        }
+        return readings;
+    }
+
+    std::vector<std::pair<const PerfGroup*, PerfReading>> start_;
+};
+
+// ",Ciclos,Instruções,IPC,LLCMisses,DTLBMisses,BranchMisses", com prefix antes de cada nome
+// nos CSVs que têm uma coluna por versão
+inline std::string perf_csv_header(const std::string& prefix = "") {
+    std::string header;
+    for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+        header += "," + prefix + PERF_EVENTS[event].column;
+        if (event == PERF_INSTRUCTIONS) header += "," + prefix + "IPC";
+    }
+    return header;
+}
+
+inline std::string perf_csv_columns(const PerfSample& sample) {
+    std::string columns;
+    char buffer[32];
+    for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+        if (sample.available[event]) {
+            std::snprintf(buffer, sizeof(buffer), ",%.0f", sample.values[event]);
+            columns += buffer;
+        } else {
+            columns += std::string(",") + PERF_UNAVAILABLE;
+        }
+        if (event == PERF_INSTRUCTIONS) {
+            if (sample.has_ipc()) {
+                std::snprintf(buffer, sizeof(buffer), ",%.3f", sample.ipc());
+                columns += buffer;
+            } else {
+                columns += std::string(",") + PERF_UNAVAILABLE;
+            }
+        }
+    }
+    return columns;
+}
+
+// "SIMD: 1.2e+09 ciclos, IPC 1.8, 3.1e+06 LLC misses, 2e+04 dTLB misses, 1e+03 branch misses"
+// (nada quando os contadores estão indisponíveis)
+inline void print_perf_sample(const std::string& name, const PerfSample& sample) {
+    if (!sample.any()) return;
+    auto value = [&](int event) -> std::string {
+        if (!sample.available[event]) return PERF_UNAVAILABLE;
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3g", sample.values[event]);
+        return buffer;
+    };
+    std::cout << name << ": " << value(PERF_CYCLES) << " ciclos, IPC "
+              << (sample.has_ipc() ? std::to_string(sample.ipc()) : PERF_UNAVAILABLE) << ", "
+              << value(PERF_LLC_MISSES) << " LLC misses, " << value(PERF_DTLB_MISSES) << " dTLB misses, "
+              << value(PERF_BRANCH_MISSES) << " branch misses" << std::endl;
+}
@@ -0,0 +1,207 @@
+#pragma once
+// Gerador de números aleatórios baseado em contador (Philox4x32-10), vetorizado com AVX2
+// e preenchido em paralelo. O valor de cada posição depende apenas de (semente, fluxo,
+// índice), então a saída é a mesma para qualquer número de threads.
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "numa.h"
+
+// Elementos gerados por vez: 8 blocos Philox (um por lane) x 4 palavras
+const size_t RANDOM_GROUP_SIZE = 32;
+
+// Constantes do Philox4x32 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+const int PHILOX_ROUNDS = 10;
+
+// Produto 32x32 -> 64 bits por lane, separado em metade alta e baixa
+inline void philox_mulhilo(__m256i a, __m256i m, __m256i& hi, __m256i& lo) {
+    __m256i even = _mm256_mul_epu32(a, m);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+// Philox4x32-10 para os blocos first_block..first_block+7 (first_block múltiplo de 8).
+// O contador é (bloco baixo, fluxo, sorteio, bloco alto) e a chave é a semente.
+inline void philox4x32_8(uint64_t seed, uint32_t stream, uint32_t draw, uint64_t first_block,
+                         __m256i words[4]) {
+    const __m256i m0 = _mm256_set1_epi32(static_cast<int>(PHILOX_M0));
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(PHILOX_M1));
+    __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first_block)),
+                                  _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i c1 = _mm256_set1_epi32(static_cast<int>(stream));
+    __m256i c2 = _mm256_set1_epi32(static_cast<int>(draw));
+    __m256i c3 = _mm256_set1_epi32(static_cast<int>(first_block >> 32));
+    uint32_t k0 = static_cast<uint32_t>(seed);
+    uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        if (round > 0) {
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        __m256i hi0, lo0, hi1, lo1;
+        philox_mulhilo(c0, m0, hi0, lo0);
+        philox_mulhilo(c2, m1, hi1, lo1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(k0)));
+        c1 = lo1;
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(k1)));
+        c3 = lo0;
+    }
+
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+}
+
+// Um grupo de RANDOM_GROUP_SIZE elementos consecutivos. O elemento w * 8 + l do grupo
+// vem da palavra w do bloco l; cada sorteio (draw) é uma sequência independente.
+class RandomGroup {
+public:
+    RandomGroup(uint64_t seed, uint32_t stream, size_t group)
+        : seed_(seed), stream_(stream), first_block_(static_cast<uint64_t>(group) * 8) {}
+
+    void bits(uint32_t draw, __m256i out[4]) const {
+        philox4x32_8(seed_, stream_, draw, first_block_, out);
+    }
+
+    // Uniformes em [0, 1) com 24 bits
+    void uniform(uint32_t draw, __m256 out[4]) const {
+        __m256i words[4];
+        bits(draw, words);
+        for (int w = 0; w < 4; w++) {
+            out[w] = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(words[w], 8)),
+                                   _mm256_set1_ps(1.0f / 16777216.0f));
+        }
+    }
+
+    // Uniformes em (0, 1], seguros para log
+    void uniform_open(uint32_t draw, __m256 out[4]) const {
+        __m256i words[4];
+        bits(draw, words);
+        for (int w = 0; w < 4; w++) {
+            __m256i mantissa = _mm256_add_epi32(_mm256_srli_epi32(words[w], 8), _mm256_set1_epi32(1));
+            out[w] = _mm256_mul_ps(_mm256_cvtepi32_ps(mantissa), _mm256_set1_ps(1.0f / 16777216.0f));
+        }
+    }
+
+private:
+    uint64_t seed_;
+    uint32_t stream_;
+    uint64_t first_block_;
+};
+
+// Logaritmo natural aproximado (polinômio do Cephes, ~1 ulp) para x > 0 normal
+inline __m256 log_ps(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                   _mm256_set1_epi32(0x3F000000)));
+
+    // m em [sqrt(1/2), sqrt(2)) - 1
+    __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, one));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(small, m)), one);
+
+    __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), _mm256_add_ps(m, y));
+}
+
+// cos(2 * pi * t) aproximado para t em [0, 1): quadrante mais próximo + polinômios
+// do Cephes em [-pi/4, pi/4]
+inline __m256 cos_turns_ps(__m256 t) {
+    __m256 s = _mm256_mul_ps(t, _mm256_set1_ps(4.0f));
+    __m256 q = _mm256_round_ps(s, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 a = _mm256_mul_ps(_mm256_sub_ps(s, q), _mm256_set1_ps(1.57079632679489662f));
+    __m256 a2 = _mm256_mul_ps(a, a);
+
+    __m256 sin_a = _mm256_set1_ps(-1.9515295891e-4f);
+    sin_a = _mm256_fmadd_ps(sin_a, a2, _mm256_set1_ps(8.3321608736e-3f));
+    sin_a = _mm256_fmadd_ps(sin_a, a2, _mm256_set1_ps(-1.6666654611e-1f));
+    sin_a = _mm256_fmadd_ps(_mm256_mul_ps(sin_a, a2), a, a);
+
+    __m256 cos_a = _mm256_set1_ps(2.443315711809948e-5f);
+    cos_a = _mm256_fmadd_ps(cos_a, a2, _mm256_set1_ps(-1.388731625493765e-3f));
+    cos_a = _mm256_fmadd_ps(cos_a, a2, _mm256_set1_ps(4.166664568298827e-2f));
+    cos_a = _mm256_mul_ps(_mm256_mul_ps(cos_a, a2), a2);
+    cos_a = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), a2, cos_a), _mm256_set1_ps(1.0f));
+
+    // cos(q * pi/2 + a): quadrantes ímpares usam sin(a); os quadrantes 1 e 2 trocam o sinal
+    __m256i quadrant = _mm256_and_si256(_mm256_cvtps_epi32(q), _mm256_set1_epi32(3));
+    __m256 odd = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)),
+                                                        _mm256_set1_epi32(1)));
+    __m256i flip = _mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2));
+    __m256 sign = _mm256_castsi256_ps(_mm256_slli_epi32(flip, 30));
+    return _mm256_xor_ps(_mm256_blendv_ps(cos_a, sin_a, odd), sign);
+}
+
+// Preencher data em paralelo: transform(const RandomGroup&, __m256 out[4]) produz os
+// RANDOM_GROUP_SIZE valores de cada grupo. Os blocos são os de for_each_thread_chunk, de modo
+// que a geração também faz o first-touch das páginas; grupos que cruzam a fronteira entre
+// dois blocos são calculados pelas duas threads e cada uma grava a sua parte.
+template<typename Vector, typename Transform>
+void fill_random(Vector& data, uint64_t seed, uint32_t stream, int num_threads, Transform transform) {
+    float* out = data.data();
+    for_each_thread_chunk(data.size(), num_threads, [&](size_t start, size_t end) {
+        size_t group = start / RANDOM_GROUP_SIZE;
+        for (size_t base = group * RANDOM_GROUP_SIZE; base < end; base += RANDOM_GROUP_SIZE, group++) {
+            __m256 values[4];
+            transform(RandomGroup(seed, stream, group), values);
+
+            if (base >= start && base + RANDOM_GROUP_SIZE <= end) {
+                for (int w = 0; w < 4; w++) {
+                    _mm256_storeu_ps(out + base + w * 8, values[w]);
+                }
+            } else {
+                alignas(32) float buffer[RANDOM_GROUP_SIZE];
+                for (int w = 0; w < 4; w++) {
+                    _mm256_store_ps(buffer + w * 8, values[w]);
+                }
+                const size_t first = std::max(base, start);
+                const size_t last = std::min(base + RANDOM_GROUP_SIZE, end);
+                std::copy(buffer + (first - base), buffer + (last - base), out + first);
+            }
+        }
+    });
+}
+
+// Uniformes em [low, high)
+template<typename Vector>
+void fill_uniform(Vector& data, float low, float high, uint64_t seed, uint32_t stream, int num_threads) {
+    const __m256 offset = _mm256_set1_ps(low);
+    const __m256 scale = _mm256_set1_ps(high - low);
+    fill_random(data, seed, stream, num_threads, [&](const RandomGroup& rng, __m256 out[4]) {
+        rng.uniform(0, out);
+        for (int w = 0; w < 4; w++) {
+            out[w] = _mm256_fmadd_ps(out[w], scale, offset);
+        }
+    });
+}
+
+// Semente para quando --seed não é informado
+inline uint64_t random_seed_from_device() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
@@ -0,0 +1,271 @@
+#pragma once
+// Tetos da máquina para o modelo roofline: bandwidth sustentada medida com os quatro
+// kernels do STREAM (copy, scale, add, triad), uma leitura pura e uma atualização in-place,
+// e pico de FLOP/s medido com cadeias independentes de FMA na ISA mais larga habilitada,
+// todos com o mesmo pool e particionamento dos benchmarks.
+// Um kernel com intensidade aritmética I (FLOPs por byte de memória) pode atingir no
+// máximo min(pico, I * bandwidth); os benchmarks informam quanto desse teto alcançaram.
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "numa.h"
+
+// Elementos de cada vetor do STREAM (3 x 128 MiB, bem acima de qualquer LLC) e
+// repetições por kernel; como no STREAM, vale a melhor repetição
+const size_t STREAM_ARRAY_SIZE = size_t(1) << 25;
+const int STREAM_TRIALS = 5;
+
+// Cadeias de FMA independentes por thread (latência x vazão de FMA, com folga) e
+// iterações de cada cadeia no teste de pico
+const int PEAK_FMA_CHAINS = 12;
+const long PEAK_FMA_ITERATIONS = 20000000;
+const int PEAK_TRIALS = 3;
+
+const double BYTES_PER_GB = 1024.0 * 1024.0 * 1024.0;  // GB no mesmo sentido dos benchmarks
+
+// Posição de um kernel no roofline
+struct RooflinePoint {
+    double intensity = 0.0;   // FLOPs por byte
+    double gflops = 0.0;      // Desempenho atingido
+    double attainable = 0.0;  // Teto para essa intensidade (GFLOP/s)
+    double percent = 0.0;     // gflops / attainable, em %
+    bool memory_bound = true; // Se o teto é a bandwidth (e não o pico de FLOPs)
+};
+
+const char* const ROOFLINE_CSV_HEADER = ",Intensidade(FLOP/B),GFLOPs,Roofline(GFLOP/s),Roofline(%)";
+
+struct Roofline {
+    int num_threads = 1;
+    double copy_bandwidth = 0.0;   // GB/s
+    double scale_bandwidth = 0.0;
+    double add_bandwidth = 0.0;
+    double triad_bandwidth = 0.0;
+    double read_bandwidth = 0.0;    // Só leitura (reduções)
+    double update_bandwidth = 0.0;  // a[i] += s * b[i] (SAXPY in-place)
+    double peak_gflops_float = 0.0;
+    double peak_gflops_double = 0.0;
+
+    // Melhor bandwidth entre as sondas, todas contando o tráfego real (com o write-allocate
+    // dos stores comuns). Os kernels contam só os bytes lógicos, então um kernel que escreve
+    // fora do lugar com stores comuns fica abaixo de 100%; leituras puras, atualizações
+    // in-place e stores não temporais, que não pagam write-allocate, chegam perto de 100%.
+    double bandwidth() const {
+        return std::max({copy_bandwidth, scale_bandwidth, add_bandwidth, triad_bandwidth, read_bandwidth,
+                         update_bandwidth});
+    }
+
+    // flops e bytes por execução; double_precision escolhe o pico em double
+    RooflinePoint evaluate(double flops, double bytes, double seconds, bool double_precision = false) const {
+        RooflinePoint point;
+        const double peak = double_precision ? peak_gflops_double : peak_gflops_float;
+        const double memory_roof = bytes > 0 ? flops / bytes * bandwidth() * BYTES_PER_GB / 1e9 : peak;
+        point.intensity = bytes > 0 ? flops / bytes : 0.0;
+        point.gflops = flops / seconds / 1e9;
+        point.memory_bound = memory_roof < peak;
+        point.attainable = std::min(peak, memory_roof);
+        point.percent = point.attainable > 0 ? point.gflops / point.attainable * 100.0 : 0.0;
+        return point;
+    }
+};
+
+// Colunas de ROOFLINE_CSV_HEADER
+inline std::string roofline_csv_columns(const RooflinePoint& point) {
+    return "," + std::to_string(point.intensity) + "," + std::to_string(point.gflops) + "," +
+           std::to_string(point.attainable) + "," + std::to_string(point.percent);
+}
+
+// Menor tempo de func() em trials repetições
+template<typename Func>
+double best_time(int trials, Func func) {
+    double best = 0.0;
+    for (int trial = 0; trial < trials; trial++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (trial == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+// STREAM em float com o particionamento de for_each_thread_chunk; os vetores são
+// inicializados pelas mesmas threads (first-touch). Os bytes incluem o write-allocate do
+// vetor escrito (lido antes da escrita): 3 vetores para copy/scale, 4 para add/triad.
+// A leitura pura move 1 vetor e a atualização in-place 3, sem write-allocate.
+inline void measure_stream_bandwidth(int num_threads, Roofline& roofline) {
+    auto a = first_touch_allocate<FloatVector>(STREAM_ARRAY_SIZE, num_threads);
+    auto b = first_touch_allocate<FloatVector>(STREAM_ARRAY_SIZE, num_threads);
+    auto c = first_touch_allocate<FloatVector>(STREAM_ARRAY_SIZE, num_threads);
+    for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+        std::fill(a.begin() + start, a.begin() + end, 1.0f);
+        std::fill(b.begin() + start, b.begin() + end, 2.0f);
+        std::fill(c.begin() + start, c.begin() + end, 0.0f);
+    });
+
+    const float scalar = 3.0f;
+    float* pa = a.data();
+    float* pb = b.data();
+    float* pc = c.data();
+    const double vector_gb = STREAM_ARRAY_SIZE * sizeof(float) / BYTES_PER_GB;
+
+    roofline.copy_bandwidth = 3.0 * vector_gb / best_time(STREAM_TRIALS, [&]() {
+        for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++) pc[i] = pa[i];
+        });
+    });
+    roofline.scale_bandwidth = 3.0 * vector_gb / best_time(STREAM_TRIALS, [&]() {
+        for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++) pb[i] = scalar * pc[i];
+        });
+    });
+    roofline.add_bandwidth = 4.0 * vector_gb / best_time(STREAM_TRIALS, [&]() {
+        for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++) pc[i] = pa[i] + pb[i];
+        });
+    });
+    roofline.triad_bandwidth = 4.0 * vector_gb / best_time(STREAM_TRIALS, [&]() {
+        for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++) pa[i] = pb[i] + scalar * pc[i];
+        });
+    });
+    roofline.update_bandwidth = 3.0 * vector_gb / best_time(STREAM_TRIALS, [&]() {
+        for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++) pa[i] = pa[i] + scalar * pb[i];
+        });
+    });
+    // Soma com 4 acumuladores vetoriais (uma só cadeia de soma seria limitada pela latência);
+    // o resultado vai para c para a leitura não ser descartada
+    roofline.read_bandwidth = vector_gb / best_time(STREAM_TRIALS, [&]() {
+        for_each_thread_chunk(STREAM_ARRAY_SIZE, num_threads, [&](size_t start, size_t end) {
+            __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+            size_t i = start;
+            for (; i + 32 <= end; i += 32) {
+                for (int k = 0; k < 4; k++) acc[k] = _mm256_add_ps(acc[k], _mm256_loadu_ps(&pa[i + 8 * k]));
+            }
+            float sum = 0.0f;
+            for (; i < end; i++) sum += pa[i];
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, _mm256_add_ps(_mm256_add_ps(acc[0], acc[1]), _mm256_add_ps(acc[2], acc[3])));
+            for (float lane : lanes) sum += lane;
+            pc[start] = sum;
+        });
+    });
+}
+
+// Operações usadas no teste de pico, por tipo de elemento e largura do registrador
+template<typename T, int Bits>
+struct PeakFma;
+
+template<>
+struct PeakFma<float, 256> {
+    using Vec = __m256;
+    static Vec set1(double value) { return _mm256_set1_ps(static_cast<float>(value)); }
+    static Vec fma(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+    static double first(Vec a) { return _mm256_cvtss_f32(a); }
+};
+
+template<>
+struct PeakFma<double, 256> {
+    using Vec = __m256d;
+    static Vec set1(double value) { return _mm256_set1_pd(value); }
+    static Vec fma(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+    static double first(Vec a) { return _mm256_cvtsd_f64(a); }
+};
+
+#ifdef __AVX512F__
+template<>
+struct PeakFma<float, 512> {
+    using Vec = __m512;
+    static Vec set1(double value) { return _mm512_set1_ps(static_cast<float>(value)); }
+    static Vec fma(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+    static double first(Vec a) { return _mm512_cvtss_f32(a); }
+};
+
+template<>
+struct PeakFma<double, 512> {
+    using Vec = __m512d;
+    static Vec set1(double value) { return _mm512_set1_pd(value); }
+    static Vec fma(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+    static double first(Vec a) { return _mm512_cvtsd_f64(a); }
+};
+#endif
+
+// PEAK_FMA_CHAINS cadeias de FMA de Bits bits por thread; cada FMA conta 2 FLOPs por lane
+template<typename T, int Bits>
+double measure_peak_gflops_width(int num_threads) {
+    using Ops = PeakFma<T, Bits>;
+    constexpr int lanes = Bits / 8 / sizeof(T);
+    std::vector<double> sinks(num_threads, 0.0);
+
+    const double seconds = best_time(PEAK_TRIALS, [&]() {
+        shared_thread_pool(num_threads).parallel_for(num_threads, 1, [&](size_t thread, size_t) {
+            typename Ops::Vec acc[PEAK_FMA_CHAINS];
+            for (int k = 0; k < PEAK_FMA_CHAINS; k++) acc[k] = Ops::set1(1.0 + k);
+            const typename Ops::Vec scale = Ops::set1(0.999999), offset = Ops::set1(1e-6);
+            for (long i = 0; i < PEAK_FMA_ITERATIONS; i++) {
+                for (int k = 0; k < PEAK_FMA_CHAINS; k++) {
+                    acc[k] = Ops::fma(acc[k], scale, offset);
+                }
+            }
+            double sum = 0.0;
+            for (int k = 0; k < PEAK_FMA_CHAINS; k++) sum += Ops::first(acc[k]);
+            sinks[thread] = sum;
+        });
+    });
+
+    volatile double sink = sinks[0];
+    (void)sink;
+    return 2.0 * lanes * PEAK_FMA_CHAINS * PEAK_FMA_ITERATIONS * num_threads / seconds / 1e9;
+}
+
+// Pico de FMA da ISA mais larga habilitada. Com AVX-512 vale o maior entre 256 e 512 bits:
+// em CPUs com uma só unidade FMA de 512 bits (ou clock reduzido em AVX-512) o AVX2 rende
+// mais, e nenhuma instanciação dos kernels deve passar do teto.
+template<typename T>
+double measure_peak_gflops(int num_threads) {
+    double peak = measure_peak_gflops_width<T, 256>(num_threads);
+#ifdef __AVX512F__
+    peak = std::max(peak, measure_peak_gflops_width<T, 512>(num_threads));
+#endif
+    return peak;
+}
+
+// Roofline com num_threads threads, medido uma vez por número de threads
+inline const Roofline& machine_roofline(int num_threads) {
+    static std::map<int, Roofline> cache;
+    auto found = cache.find(num_threads);
+    if (found != cache.end()) return found->second;
+
+    Roofline roofline;
+    roofline.num_threads = num_threads;
+    measure_stream_bandwidth(num_threads, roofline);
+    roofline.peak_gflops_float = measure_peak_gflops<float>(num_threads);
+    roofline.peak_gflops_double = measure_peak_gflops<double>(num_threads);
+    return cache.emplace(num_threads, roofline).first->second;
+}
+
+// "Roofline (8 threads): STREAM copy 30 / scale 30 / add 29 / triad 29 / leitura 25 / in-place 27 GB/s
+// (com write-allocate), pico FMA 500/250 GFLOP/s"
+inline void print_roofline(const Roofline& roofline) {
+    std::cout << "Roofline (" << roofline.num_threads << " thread(s)): STREAM copy "
+              << roofline.copy_bandwidth << " / scale " << roofline.scale_bandwidth << " / add "
+              << roofline.add_bandwidth << " / triad " << roofline.triad_bandwidth << " / leitura "
+              << roofline.read_bandwidth << " / in-place " << roofline.update_bandwidth
+              << " GB/s (com write-allocate), pico FMA " << roofline.peak_gflops_float << " GFLOP/s (float), "
+              << roofline.peak_gflops_double << " GFLOP/s (double)" << std::endl;
+}
+
+// "SIMD: 0.17 FLOP/B, 3.2 GFLOP/s = 85% do teto de memória (3.8 GFLOP/s)"
+inline void print_roofline_point(const std::string& name, const RooflinePoint& point) {
+    std::cout << name << ": " << point.intensity << " FLOP/B, " << point.gflops << " GFLOP/s = "
+              << point.percent << "% do teto " << (point.memory_bound ? "de memória" : "de cálculo")
+              << " (" << point.attainable << " GFLOP/s)" << std::endl;
+}
@@ -0,0 +1,289 @@
+#pragma once
+// Operações vetoriais parametrizadas por tipo (float/double) e conjunto de instruções
+// (escalar, SSE, AVX2, AVX-512), para que cada kernel seja escrito uma vez e instanciado
+// em todas as combinações. Cada operação escolhe o intrínseco com if constexpr, então uma
+// instanciação compila para o mesmo código que a versão escrita à mão. Só os conjuntos
+// habilitados na compilação (-march=native) podem ser instanciados.
+
+#include <immintrin.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+enum class Isa {
+    SCALAR,  // Código C++ comum (o compilador ainda pode vetorizá-lo sozinho)
+    SSE,     // Registradores de 128 bits
+    AVX2,    // 256 bits
+    AVX512   // 512 bits
+};
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "Escalar";
+        case Isa::SSE: return "SSE";
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+    }
+    return "?";
+}
+
+#ifdef __FMA__
+constexpr bool SIMD_HAVE_FMA = true;
+#else
+constexpr bool SIMD_HAVE_FMA = false;
+#endif
+
+// Conjuntos de instruções habilitados na compilação
+constexpr bool isa_enabled(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return true;
+#ifdef __SSE2__
+        case Isa::SSE: return true;
+#endif
+#ifdef __AVX2__
+        case Isa::AVX2: return true;
+#endif
+#ifdef __AVX512F__
+        case Isa::AVX512: return true;
+#endif
+        default: return false;
+    }
+}
+
+template<typename T>
+constexpr const char* type_name() {
+    return std::is_same<T, float>::value ? "float" : "double";
+}
+
+// Registrador, máscara de comparação e contadores inteiros de 32 bits (um por lane) de cada
+// combinação. Até o AVX2 a máscara é um registrador com todos os bits da lane ligados; no
+// AVX-512 é um registrador k. Em double os contadores ocupam metade da largura do vetor.
+template<typename T, Isa isa>
+struct SimdRegister {
+    using Vec = T;
+    using Mask = bool;
+    using Counter = int32_t;
+};
+
+template<> struct SimdRegister<float, Isa::SSE> { using Vec = __m128; using Mask = __m128; using Counter = __m128i; };
+template<> struct SimdRegister<double, Isa::SSE> { using Vec = __m128d; using Mask = __m128d; using Counter = __m128i; };
+template<> struct SimdRegister<float, Isa::AVX2> { using Vec = __m256; using Mask = __m256; using Counter = __m256i; };
+template<> struct SimdRegister<double, Isa::AVX2> { using Vec = __m256d; using Mask = __m256d; using Counter = __m128i; };
+template<> struct SimdRegister<float, Isa::AVX512> { using Vec = __m512; using Mask = __mmask16; using Counter = __m512i; };
+template<> struct SimdRegister<double, Isa::AVX512> { using Vec = __m512d; using Mask = __mmask8; using Counter = __m256i; };
+
+template<typename T, Isa I>
+struct Simd {
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value, "tipo deve ser float ou double");
+    static_assert(isa_enabled(I), "conjunto de instruções não habilitado na compilação");
+
+    using Vec = typename SimdRegister<T, I>::Vec;
+    using Mask = typename SimdRegister<T, I>::Mask;
+    using Counter = typename SimdRegister<T, I>::Counter;
+    static constexpr int lanes = sizeof(Vec) / sizeof(T);
+    static constexpr size_t alignment = sizeof(Vec);  // Exigido por stream
+    static constexpr bool single = std::is_same<T, float>::value;
+
+    static Vec set1(T value) {
+        if constexpr (I == Isa::SCALAR) return value;
+        else if constexpr (I == Isa::SSE && single) return _mm_set1_ps(value);
+        else if constexpr (I == Isa::SSE) return _mm_set1_pd(value);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_set1_ps(value);
+        else if constexpr (I == Isa::AVX2) return _mm256_set1_pd(value);
+        else if constexpr (single) return _mm512_set1_ps(value);
+        else return _mm512_set1_pd(value);
+    }
+
+    static Vec zero() { return set1(T(0)); }
+
+    // 0, 1, 2, ... (índice de cada lane)
+    static Vec iota() {
+        alignas(64) T values[lanes];
+        for (int k = 0; k < lanes; k++) values[k] = static_cast<T>(k);
+        return load(values);
+    }
+
+    static Vec load(const T* p) {
+        if constexpr (I == Isa::SCALAR) return *p;
+        else if constexpr (I == Isa::SSE && single) return _mm_loadu_ps(p);
+        else if constexpr (I == Isa::SSE) return _mm_loadu_pd(p);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_loadu_ps(p);
+        else if constexpr (I == Isa::AVX2) return _mm256_loadu_pd(p);
+        else if constexpr (single) return _mm512_loadu_ps(p);
+        else return _mm512_loadu_pd(p);
+    }
+
+    static void store(T* p, Vec v) {
+        if constexpr (I == Isa::SCALAR) *p = v;
+        else if constexpr (I == Isa::SSE && single) _mm_storeu_ps(p, v);
+        else if constexpr (I == Isa::SSE) _mm_storeu_pd(p, v);
+        else if constexpr (I == Isa::AVX2 && single) _mm256_storeu_ps(p, v);
+        else if constexpr (I == Isa::AVX2) _mm256_storeu_pd(p, v);
+        else if constexpr (single) _mm512_storeu_ps(p, v);
+        else _mm512_storeu_pd(p, v);
+    }
+
+    // Store não temporal; p alinhado em alignment bytes. Quem usa faz o _mm_sfence.
+    static void stream(T* p, Vec v) {
+        if constexpr (I == Isa::SCALAR) *p = v;
+        else if constexpr (I == Isa::SSE && single) _mm_stream_ps(p, v);
+        else if constexpr (I == Isa::SSE) _mm_stream_pd(p, v);
+        else if constexpr (I == Isa::AVX2 && single) _mm256_stream_ps(p, v);
+        else if constexpr (I == Isa::AVX2) _mm256_stream_pd(p, v);
+        else if constexpr (single) _mm512_stream_ps(p, v);
+        else _mm512_stream_pd(p, v);
+    }
+
+    static Vec add(Vec a, Vec b) {
+        if constexpr (I == Isa::SCALAR) return a + b;
+        else if constexpr (I == Isa::SSE && single) return _mm_add_ps(a, b);
+        else if constexpr (I == Isa::SSE) return _mm_add_pd(a, b);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_add_ps(a, b);
+        else if constexpr (I == Isa::AVX2) return _mm256_add_pd(a, b);
+        else if constexpr (single) return _mm512_add_ps(a, b);
+        else return _mm512_add_pd(a, b);
+    }
+
+    static Vec sub(Vec a, Vec b) {
+        if constexpr (I == Isa::SCALAR) return a - b;
+        else if constexpr (I == Isa::SSE && single) return _mm_sub_ps(a, b);
+        else if constexpr (I == Isa::SSE) return _mm_sub_pd(a, b);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_sub_ps(a, b);
+        else if constexpr (I == Isa::AVX2) return _mm256_sub_pd(a, b);
+        else if constexpr (single) return _mm512_sub_ps(a, b);
+        else return _mm512_sub_pd(a, b);
+    }
+
+    static Vec mul(Vec a, Vec b) {
+        if constexpr (I == Isa::SCALAR) return a * b;
+        else if constexpr (I == Isa::SSE && single) return _mm_mul_ps(a, b);
+        else if constexpr (I == Isa::SSE) return _mm_mul_pd(a, b);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_mul_ps(a, b);
+        else if constexpr (I == Isa::AVX2) return _mm256_mul_pd(a, b);
+        else if constexpr (single) return _mm512_mul_ps(a, b);
+        else return _mm512_mul_pd(a, b);
+    }
+
+    // a * b + c, com um único arredondamento quando há FMA (em todas as larguras, para que
+    // as instanciações de um kernel deem resultados idênticos)
+    static Vec fmadd(Vec a, Vec b, Vec c) {
+        if constexpr (!SIMD_HAVE_FMA) return add(mul(a, b), c);
+        else if constexpr (I == Isa::SCALAR) return std::fma(a, b, c);
+        else if constexpr (I == Isa::SSE && single) return _mm_fmadd_ps(a, b, c);
+        else if constexpr (I == Isa::SSE) return _mm_fmadd_pd(a, b, c);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_fmadd_ps(a, b, c);
+        else if constexpr (I == Isa::AVX2) return _mm256_fmadd_pd(a, b, c);
+        else if constexpr (single) return _mm512_fmadd_ps(a, b, c);
+        else return _mm512_fmadd_pd(a, b, c);
+    }
+
+    static Vec sqrt(Vec a) {
+        if constexpr (I == Isa::SCALAR) return std::sqrt(a);
+        else if constexpr (I == Isa::SSE && single) return _mm_sqrt_ps(a);
+        else if constexpr (I == Isa::SSE) return _mm_sqrt_pd(a);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_sqrt_ps(a);
+        else if constexpr (I == Isa::AVX2) return _mm256_sqrt_pd(a);
+        else if constexpr (single) return _mm512_sqrt_ps(a);
+        else return _mm512_sqrt_pd(a);
+    }
+
+    // a < b por lane (falso com NaN)
+    static Mask less(Vec a, Vec b) {
+        if constexpr (I == Isa::SCALAR) return a < b;
+        else if constexpr (I == Isa::SSE && single) return _mm_cmplt_ps(a, b);
+        else if constexpr (I == Isa::SSE) return _mm_cmplt_pd(a, b);
+        else if constexpr (I == Isa::AVX2 && single) return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+        else if constexpr (I == Isa::AVX2) return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+        else if constexpr (single) return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+        else return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+    }
+
+    static Mask both(Mask a, Mask b) {
+        if constexpr (I == Isa::SCALAR || I == Isa::AVX512) return a & b;
+        else if constexpr (I == Isa::SSE && single) return _mm_and_ps(a, b);
+        else if constexpr (I == Isa::SSE) return _mm_and_pd(a, b);
+        else if constexpr (single) return _mm256_and_ps(a, b);
+        else return _mm256_and_pd(a, b);
+    }
+
+    // Alguma lane ligada
+    static bool any(Mask m) {
+        if constexpr (I == Isa::SCALAR || I == Isa::AVX512) return m != 0;
+        else if constexpr (I == Isa::SSE && single) return _mm_movemask_ps(m) != 0;
+        else if constexpr (I == Isa::SSE) return _mm_movemask_pd(m) != 0;
+        else if constexpr (single) return _mm256_movemask_ps(m) != 0;
+        else return _mm256_movemask_pd(m) != 0;
+    }
+
+    static Counter counter_zero() {
+        if constexpr (I == Isa::SCALAR) return 0;
+        else if constexpr (I == Isa::SSE || (I == Isa::AVX2 && !single)) return _mm_setzero_si128();
+        else if constexpr (I == Isa::AVX2 || !single) return _mm256_setzero_si256();
+        else return _mm512_setzero_si512();
+    }
+
+    // +1 nos contadores das lanes ligadas em m. Até o AVX2 a máscara vale -1 nas lanes
+    // ligadas e é subtraída; em double as metades baixas das lanes de 64 bits são
+    // compactadas antes. No AVX-512 é uma soma mascarada.
+    static Counter counter_increment(Counter c, Mask m) {
+        if constexpr (I == Isa::SCALAR) return c + (m ? 1 : 0);
+        else if constexpr (I == Isa::SSE && single) return _mm_sub_epi32(c, _mm_castps_si128(m));
+        else if constexpr (I == Isa::SSE) {
+            return _mm_sub_epi32(c, _mm_shuffle_epi32(_mm_castpd_si128(m), _MM_SHUFFLE(2, 2, 2, 0)));
+        } else if constexpr (I == Isa::AVX2 && single) {
+            return _mm256_sub_epi32(c, _mm256_castps_si256(m));
+        } else if constexpr (I == Isa::AVX2) {
+            const __m128 low = _mm_castpd_ps(_mm256_castpd256_pd128(m));
+            const __m128 high = _mm_castpd_ps(_mm256_extractf128_pd(m, 1));
+            return _mm_sub_epi32(c, _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0))));
+        } else if constexpr (single) {
+            return _mm512_mask_add_epi32(c, m, c, _mm512_set1_epi32(1));
+        } else {
+            const __m512i wide = _mm512_castsi256_si512(c);
+            return _mm512_castsi512_si256(_mm512_mask_add_epi32(wide, m, wide, _mm512_set1_epi32(1)));
+        }
+    }
+
+    // Gravar em p um int32_t por lane
+    static void counter_store(int32_t* p, Counter c) {
+        if constexpr (I == Isa::SCALAR) *p = c;
+        else if constexpr (I == Isa::SSE && !single) _mm_storel_epi64(reinterpret_cast<__m128i*>(p), c);
+        else if constexpr (I == Isa::SSE || (I == Isa::AVX2 && !single)) _mm_storeu_si128(reinterpret_cast<__m128i*>(p), c);
+        else if constexpr (I == Isa::AVX2 || !single) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), c);
+        else _mm512_storeu_si512(p, c);
+    }
+};
+
+// Uma instanciação de kernel: tipo, conjunto de instruções e vetores por iteração
+template<typename T, Isa I, int Unroll>
+struct KernelConfig {
+    using type = T;
+    static constexpr Isa isa = I;
+    static constexpr int unroll = Unroll;
+
+    // "double AVX2 x4"
+    static std::string name() {
+        return std::string(type_name<T>()) + " " + isa_name(I) + " x" + std::to_string(Unroll);
+    }
+};
+
+template<typename T, Isa I, typename Func>
+void for_each_unroll(Func& func) {
+    if constexpr (isa_enabled(I)) {
+        func(KernelConfig<T, I, 1>{});
+        func(KernelConfig<T, I, 2>{});
+        func(KernelConfig<T, I, 4>{});
+    }
+}
+
+// Chamar func(KernelConfig<T, isa, unroll>{}) para cada conjunto de instruções habilitado
+// e desenrolamento 1, 2 e 4: a matriz de instanciações de um tipo
+template<typename T, typename Func>
+void for_each_kernel_config(Func func) {
+    for_each_unroll<T, Isa::SCALAR>(func);
+    for_each_unroll<T, Isa::SSE>(func);
+    for_each_unroll<T, Isa::AVX2>(func);
+    for_each_unroll<T, Isa::AVX512>(func);
+}
@@ -0,0 +1,279 @@
+#pragma once
+// Varredura de working set: tamanhos em escala logarítmica de 4 KiB até alguns GiB,
+// sempre sobre os mesmos buffers (alocados e preenchidos uma vez, com fatias crescentes),
+// para expor os degraus de bandwidth de L1, L2, LLC e DRAM e o tamanho a partir do qual as
+// versões multi-thread passam a compensar. Tamanhos pequenos repetem o kernel várias
+// vezes por amostra, para que cada amostra fique bem acima da resolução do relógio.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.h"
+#include "numa.h"
+#include "roofline.h"
+
+// Working sets de SWEEP_MIN_BYTES até SWEEP_MAX_BYTES, com SWEEP_POINTS_PER_OCTAVE
+// tamanhos por oitava
+const size_t SWEEP_MIN_BYTES = 4 * 1024;
+const size_t SWEEP_MAX_BYTES = size_t(4) << 30;
+const int SWEEP_POINTS_PER_OCTAVE = 4;
+
+// Tráfego mínimo por amostra: abaixo disso o kernel é chamado várias vezes por amostra
+const size_t SWEEP_BATCH_BYTES = 32 * 1024 * 1024;
+
+// Tempo mínimo medido por ponto (menor que o do harness: a varredura tem centenas de pontos)
+const double SWEEP_MIN_TIME = 0.05;
+
+// Fração da memória livre que a varredura pode ocupar
+const double SWEEP_MEMORY_FRACTION = 0.75;
+
+// Maior working set da varredura (--sweep-max-mb)
+inline size_t sweep_max_bytes = SWEEP_MAX_BYTES;
+
+// Nível de cache de dados (ou unificada) da CPU 0
+struct CacheLevel {
+    std::string name;  // "L1d", "L2", "L3"
+    size_t size = 0;   // Bytes por instância (por núcleo nas caches privadas)
+};
+
+// Caches de dados em ordem de nível, lidas do sysfs (com sysconf como alternativa)
+inline const std::vector<CacheLevel>& cache_levels() {
+    static const std::vector<CacheLevel> levels = []() {
+        std::map<int, size_t> sizes;
+        for (int index = 0;; index++) {
+            const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+            std::ifstream level_file(dir + "level"), type_file(dir + "type"), size_file(dir + "size");
+            if (!level_file || !type_file || !size_file) break;
+            int level = 0;
+            std::string type, size;
+            level_file >> level;
+            type_file >> type;
+            size_file >> size;
+            if (type == "Instruction" || size.empty()) continue;
+            size_t bytes = std::stoul(size);
+            if (size.back() == 'K') bytes <<= 10;
+            if (size.back() == 'M') bytes <<= 20;
+            sizes[level] = bytes;
+        }
+        if (sizes.empty()) {
+            const long reported[] = {sysconf(_SC_LEVEL1_DCACHE_SIZE), sysconf(_SC_LEVEL2_CACHE_SIZE),
+                                     sysconf(_SC_LEVEL3_CACHE_SIZE)};
+            for (int level = 1; level <= 3; level++) {
+                if (reported[level - 1] > 0) sizes[level] = static_cast<size_t>(reported[level - 1]);
+            }
+        }
+
+        std::vector<CacheLevel> result;
+        for (const auto& [level, bytes] : sizes) {
+            result.push_back({"L" + std::to_string(level) + (level == 1 ? "d" : ""), bytes});
+        }
+        return result;
+    }();
+    return levels;
+}
+
+// Primeiro nível em que o working set cabe, ou "DRAM". Usa os tamanhos por núcleo: nas
+// versões multi-thread as caches privadas somadas são maiores e o degrau aparece depois.
+inline std::string cache_tier(size_t bytes) {
+    for (const CacheLevel& level : cache_levels()) {
+        if (bytes <= level.size) return level.name;
+    }
+    return "DRAM";
+}
+
+// "48 KiB", "1.5 MiB", "2 GiB"
+inline std::string format_bytes(double bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 4) {
+        bytes /= 1024.0;
+        unit++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.4g %s", bytes, units[unit]);
+    return buffer;
+}
+
+// Maior working set possível: sweep_max_bytes, limitado pela memória livre
+inline size_t sweep_limit_bytes() {
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || page_size <= 0) return sweep_max_bytes;
+    const size_t available = static_cast<size_t>(SWEEP_MEMORY_FRACTION * pages * page_size);
+    return std::min(sweep_max_bytes, available);
+}
+
+// Elementos de cada ponto da varredura, para working_set_bytes bytes por elemento.
+// Múltiplos de 16 elementos, como os blocos de thread_chunk.
+inline std::vector<size_t> sweep_sizes(size_t working_set_bytes, size_t max_bytes) {
+    std::vector<size_t> sizes;
+    for (int point = 0;; point++) {
+        const double bytes = SWEEP_MIN_BYTES * std::exp2(static_cast<double>(point) / SWEEP_POINTS_PER_OCTAVE);
+        if (bytes > max_bytes) break;
+        const size_t elements = std::max<size_t>(16, static_cast<size_t>(bytes / working_set_bytes) / 16 * 16);
+        if (sizes.empty() || elements != sizes.back()) sizes.push_back(elements);
+    }
+    return sizes;
+}
+
+// Opção --sweep-max-mb; devolve true se argv[i] era essa opção (valores malformados lançam
+// a exceção de parse_number)
+inline bool parse_sweep_option(int argc, char* argv[], int& i) {
+    const std::string arg = argv[i];
+    if (arg == "--sweep-max-mb" && i + 1 < argc) {
+        const size_t megabytes = parse_number<size_t>(arg, argv[++i]);
+        if (megabytes > (SIZE_MAX >> 20)) {
+            throw std::out_of_range("Valor fora do intervalo para " + arg + ": '" + argv[i] + "'");
+        }
+        sweep_max_bytes = std::max<size_t>(SWEEP_MIN_BYTES, megabytes << 20);
+        return true;
+    }
+    return false;
+}
+
+const char* const SWEEP_USAGE =
+    "  --sweep-max-mb N  maior working set da varredura de tamanhos, em MiB (padrão 4096)\n";
+
+// Versão medida na varredura; run(n) executa o kernel sobre os primeiros n elementos
+struct SweepVariant {
+    std::string name;
+    int num_threads;  // 1 nas versões de uma thread
+    std::function<void(size_t)> run;
+};
+
+// Par (versão de uma thread, versão multi-thread) cujo cruzamento é procurado
+struct SweepCrossover {
+    std::string single;
+    std::string threaded;
+};
+
+// Trabalho por elemento: bytes do working set (o que precisa caber na cache), bytes
+// de tráfego (para a bandwidth, como nos outros CSVs) e FLOPs (para o roofline)
+struct SweepWork {
+    size_t working_set_bytes;
+    double traffic_bytes;
+    double flops;
+};
+
+// Menor working set a partir do qual threaded é mais rápida que single em todos os
+// tamanhos maiores, com os intervalos de confiança separados (limite inferior da
+// multi-thread acima do superior da outra); 0 se isso não acontece
+inline size_t find_crossover(const std::vector<size_t>& working_sets, const std::vector<double>& single_high,
+                             const std::vector<double>& threaded_low) {
+    size_t crossover = 0;
+    for (size_t i = working_sets.size(); i-- > 0;) {
+        if (threaded_low[i] <= single_high[i]) break;
+        crossover = working_sets[i];
+    }
+    return crossover;
+}
+
+// Varredura completa de program: uma linha por (tamanho, versão) em <program>_sweep.csv,
+// os níveis de cache e cruzamentos em <program>_sweep_marks.csv, as medições no CSV comum
+// do harness e um resumo de bandwidth por nível
+inline void run_working_set_sweep(const std::string& program, const std::vector<SweepVariant>& variants,
+                                  const std::vector<SweepCrossover>& crossovers, const SweepWork& work,
+                                  size_t max_elements, HarnessCsv& timings) {
+    const std::vector<size_t> sizes = sweep_sizes(work.working_set_bytes, max_elements * work.working_set_bytes);
+    HarnessOptions options = harness_options;
+    options.min_time = std::min(options.min_time, SWEEP_MIN_TIME);
+
+    std::cout << "Níveis de cache:";
+    for (const CacheLevel& level : cache_levels()) std::cout << " " << level.name << " " << format_bytes(level.size);
+    std::cout << std::endl;
+    std::cout << sizes.size() << " tamanhos de " << format_bytes(sizes.front() * work.working_set_bytes) << " a "
+              << format_bytes(sizes.back() * work.working_set_bytes) << " (" << SWEEP_POINTS_PER_OCTAVE
+              << " por oitava)" << std::endl;
+
+    const std::string csv_path = program + "_sweep.csv";
+    std::ofstream csv_file(csv_path);
+    csv_file << "WorkingSet(B),Elementos,Nível,Variante,Threads,Lote,Execuções,Mediana(s),Bandwidth(GB/s),"
+             << "BandwidthICInf(GB/s),BandwidthICSup(GB/s),Roofline(%)" << NUMA_CSV_HEADER << "\n";
+
+    // bandwidths[v][i]: mediana da versão v no tamanho i, com o intervalo de confiança
+    std::vector<std::vector<double>> bandwidths(variants.size(), std::vector<double>(sizes.size()));
+    std::vector<std::vector<double>> bandwidths_low = bandwidths, bandwidths_high = bandwidths;
+    std::vector<size_t> working_sets;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        const size_t elements = sizes[i];
+        const size_t working_set = elements * work.working_set_bytes;
+        const double traffic = elements * work.traffic_bytes;
+        const int batch = static_cast<int>(std::max<double>(1.0, SWEEP_BATCH_BYTES / traffic));
+        const std::string tier = cache_tier(working_set);
+        working_sets.push_back(working_set);
+
+        std::cout << "  " << format_bytes(working_set) << " (" << tier << "):";
+        for (size_t v = 0; v < variants.size(); v++) {
+            const SweepVariant& variant = variants[v];
+            const TimingStats stats =
+                measure_stats(timings, "varredura", variant.name, elements, variant.num_threads,
+                              [&]() { variant.run(elements); }, options, batch);
+            const double bandwidth = traffic / BYTES_PER_GB / stats.median;
+            bandwidths_low[v][i] = traffic / BYTES_PER_GB / stats.ci_high;
+            bandwidths_high[v][i] = traffic / BYTES_PER_GB / stats.ci_low;
+            const RooflinePoint point = machine_roofline(variant.num_threads)
+                                            .evaluate(work.flops * elements, traffic, stats.median);
+            bandwidths[v][i] = bandwidth;
+            csv_file << working_set << "," << elements << "," << tier << "," << variant.name << ","
+                     << variant.num_threads << "," << batch << "," << stats.runs() << "," << stats.median << ","
+                     << bandwidth << "," << bandwidths_low[v][i] << "," << bandwidths_high[v][i] << ","
+                     << point.percent << numa_csv_columns()
+                     << "\n";
+            std::cout << " " << variant.name << " " << bandwidth << (v + 1 < variants.size() ? " |" : " GB/s");
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Resultados salvos em " << csv_path << std::endl;
+
+    // Bandwidth mediana de cada versão dentro de cada nível
+    std::vector<std::string> tiers;
+    for (const CacheLevel& level : cache_levels()) tiers.push_back(level.name);
+    tiers.push_back("DRAM");
+    std::cout << "\nBandwidth mediana por nível (GB/s):" << std::endl;
+    for (size_t v = 0; v < variants.size(); v++) {
+        std::cout << "  " << variants[v].name << ":";
+        for (const std::string& tier : tiers) {
+            std::vector<double> values;
+            for (size_t i = 0; i < sizes.size(); i++) {
+                if (cache_tier(working_sets[i]) == tier) values.push_back(bandwidths[v][i]);
+            }
+            if (!values.empty()) std::cout << " " << tier << " " << median_of(values);
+        }
+        std::cout << std::endl;
+    }
+
+    const std::string marks_path = program + "_sweep_marks.csv";
+    std::ofstream marks_file(marks_path);
+    marks_file << "Marca,Tipo,WorkingSet(B)\n";
+    for (const CacheLevel& level : cache_levels()) marks_file << level.name << ",cache," << level.size << "\n";
+
+    std::cout << "\nCruzamento multi-thread (mais rápida em todos os tamanhos a partir de):" << std::endl;
+    for (const SweepCrossover& pair : crossovers) {
+        size_t single = variants.size(), threaded = variants.size();
+        for (size_t v = 0; v < variants.size(); v++) {
+            if (variants[v].name == pair.single) single = v;
+            if (variants[v].name == pair.threaded) threaded = v;
+        }
+        if (single == variants.size() || threaded == variants.size()) continue;
+        const size_t crossover = find_crossover(working_sets, bandwidths_high[single], bandwidths_low[threaded]);
+        std::cout << "  " << pair.threaded << " x " << pair.single << ": "
+                  << (crossover > 0 ? format_bytes(crossover) + " (" + cache_tier(crossover) + ")"
+                                    : std::string("não compensa na faixa medida"))
+                  << std::endl;
+        if (crossover > 0) marks_file << pair.threaded << " x " << pair.single << ",cruzamento," << crossover << "\n";
+    }
+    std::cout << "Níveis e cruzamentos salvos em " << marks_path << std::endl;
+}
@@ -0,0 +1,195 @@
+#pragma once
+// Pool de threads persistente compartilhado pelos três experimentos.
+// Os workers esperam trabalho girando por um curto período e depois dormem numa
+// variável de condição (spin-then-park), o que evita criar threads a cada chamada
+// sem manter CPUs ocupadas entre benchmarks.
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Iterações de espera ativa (com pause) antes de dormir. Só se gira quando cada worker
+// e a thread que despacha têm uma CPU própria; caso contrário a espera ativa apenas
+// roubaria tempo da thread que está trabalhando.
+const int THREAD_POOL_SPIN_ITERATIONS = 2000;
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_threads)
+        : num_workers_(std::max(1, num_threads)),
+          spin_iterations_(num_workers_ < static_cast<int>(std::thread::hardware_concurrency())
+                           ? THREAD_POOL_SPIN_ITERATIONS : 0) {
+        for (int i = 0; i < num_workers_; i++) {
+            workers_.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+        work_available_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return num_workers_; }
+
+    // Executar fn(begin, end) sobre [0, range) em blocos de grain elementos.
+    // O bloco k vai sempre para o worker k % size(), de modo que um particionamento
+    // fixo (como o do first-touch NUMA) é processado sempre pelas mesmas threads.
+    // Não pode ser chamado de dentro de um worker.
+    template<typename Func>
+    void parallel_for(size_t range, size_t grain, Func fn) {
+        if (range == 0) return;
+        Job job;
+        job.range = range;
+        job.grain = std::max<size_t>(grain, 1);
+        job.num_chunks = (range + job.grain - 1) / job.grain;
+        job.context = &fn;
+        job.invoke = [](void* context, size_t begin, size_t end) {
+            (*static_cast<Func*>(context))(begin, end);
+        };
+        run(job);
+    }
+
+private:
+    struct Job {
+        void (*invoke)(void* context, size_t begin, size_t end);
+        void* context;
+        size_t range, grain, num_chunks;
+    };
+
+    void run(const Job& job) {
+        std::lock_guard<std::mutex> dispatch(dispatch_mutex_);
+        job_ = job;
+        pending_.store(num_workers_, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+        work_available_.notify_all();
+
+        for (int spin = 0; pending_.load(std::memory_order_acquire) != 0; spin++) {
+            if (spin < spin_iterations_) {
+                _mm_pause();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_done_.wait(lock, [&]() { return pending_.load(std::memory_order_acquire) == 0; });
+            break;
+        }
+    }
+
+    void worker_loop(int index) {
+        uint64_t seen = 0;
+        while (true) {
+            uint64_t generation;
+            for (int spin = 0; (generation = generation_.load(std::memory_order_acquire)) == seen; spin++) {
+                if (spin < spin_iterations_) {
+                    _mm_pause();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_available_.wait(lock, [&]() {
+                    return generation_.load(std::memory_order_acquire) != seen;
+                });
+                spin = 0;
+            }
+            seen = generation;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stopping_) return;
+            lock.unlock();
+
+            const Job job = job_;
+            for (size_t chunk = index; chunk < job.num_chunks; chunk += num_workers_) {
+                size_t begin = chunk * job.grain;
+                job.invoke(job.context, begin, std::min(begin + job.grain, job.range));
+            }
+
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> done(mutex_);
+                work_done_.notify_one();
+            }
+        }
+    }
+
+    const int num_workers_;
+    const int spin_iterations_;
+    std::vector<std::thread> workers_;
+
+    std::mutex dispatch_mutex_;  // Um parallel_for por vez
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable work_done_;
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<int> pending_{0};
+    bool stopping_ = false;
+    Job job_{};
+};
+
+// Pool compartilhado com num_threads workers; recriado se o tamanho mudar.
+// Deve ser usado por uma thread de cada vez (a thread principal dos benchmarks).
+inline ThreadPool& shared_thread_pool(int num_threads) {
+    static std::unique_ptr<ThreadPool> pool;
+    if (!pool || pool->size() != num_threads) {
+        pool.reset();
+        pool = std::make_unique<ThreadPool>(num_threads);
+    }
+    return *pool;
+}
+
+// Mesmo contrato de ThreadPool::parallel_for, mas criando num_threads threads a cada
+// chamada (a forma anterior ao pool, mantida para medir o custo de despacho)
+template<typename Func>
+void spawn_parallel_for(size_t range, size_t grain, int num_threads, Func fn) {
+    grain = std::max<size_t>(grain, 1);
+    const size_t num_chunks = (range + grain - 1) / grain;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+        threads.emplace_back([&, i]() {
+            for (size_t chunk = i; chunk < num_chunks; chunk += num_threads) {
+                size_t begin = chunk * grain;
+                fn(begin, std::min(begin + grain, range));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Custo médio (s) de despachar um parallel_for vazio com o pool e criando threads
+inline void measure_dispatch_overhead(int num_threads, int calls, double& pool_time, double& spawn_time) {
+    std::atomic<size_t> sink{0};
+    auto empty = [&](size_t begin, size_t) { sink.fetch_add(begin, std::memory_order_relaxed); };
+    ThreadPool& pool = shared_thread_pool(num_threads);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < calls; i++) {
+        pool.parallel_for(num_threads, 1, empty);
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < calls; i++) {
+        spawn_parallel_for(num_threads, 1, num_threads, empty);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    pool_time = std::chrono::duration<double>(middle - start).count() / calls;
+    spawn_time = std::chrono::duration<double>(end - middle).count() / calls;
+}
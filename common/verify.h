@@ -0,0 +1,242 @@
+#pragma once
+// Verificação paralela e vetorizada de resultados: compara dois buffers de float (ou de
+// double, em escalar) e informa o maior erro em ULPs, o erro relativo médio e quantos
+// elementos passam da tolerância. Usa o mesmo particionamento dos kernels, então cada thread lê as páginas
+// que ela mesma tocou primeiro.
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "numa.h"
+
+struct VerifyResult {
+    size_t count = 0;                 // Elementos comparados
+    size_t mismatches = 0;            // Elementos fora da tolerância
+    uint32_t max_ulp = 0;             // Maior distância em ULPs (UINT32_MAX para NaN)
+    size_t max_ulp_index = 0;         // Posição do maior erro
+    double mean_relative_error = 0.0; // Média de |atual - esperado| / |esperado| (esperado != 0)
+    float max_abs_error = 0.0f;       // Maior |atual - esperado|
+    double seconds = 0.0;             // Tempo gasto na verificação
+
+    bool ok() const { return mismatches == 0; }
+};
+
+// Inteiro com a mesma ordem dos floats (-0 e +0 coincidem)
+inline __m256i ordered_float_bits(__m256 value) {
+    __m256i bits = _mm256_castps_si256(value);
+    __m256i negated = _mm256_sub_epi32(_mm256_set1_epi32(INT32_MIN), bits);
+    return _mm256_castps_si256(_mm256_blendv_ps(value, _mm256_castsi256_ps(negated), value));
+}
+
+inline uint32_t ulp_distance(float expected, float actual) {
+    if (std::isnan(expected) || std::isnan(actual)) return UINT32_MAX;
+    auto ordered = [](float value) {
+        int32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? static_cast<int32_t>(static_cast<uint32_t>(INT32_MIN) - static_cast<uint32_t>(bits)) : bits;
+    };
+    int32_t a = ordered(expected), b = ordered(actual);
+    return a > b ? static_cast<uint32_t>(a) - static_cast<uint32_t>(b)
+                 : static_cast<uint32_t>(b) - static_cast<uint32_t>(a);
+}
+
+struct VerifyPartial {
+    size_t mismatches = 0;
+    uint32_t max_ulp = 0;
+    size_t max_ulp_index = 0;
+    double relative_sum = 0.0;
+    size_t relative_count = 0;
+    float max_abs_error = 0.0f;
+};
+
+// Blocos de 8 somados em float antes de passar para o acumulador em double
+const size_t VERIFY_FLUSH_BLOCKS = 64;
+
+// Um elemento diverge se estiver a mais de max_ulps ULPs E a mais de abs_tolerance do
+// esperado; a tolerância absoluta cobre resultados pequenos obtidos por cancelamento,
+// em que poucos ULPs dos operandos viram muitos ULPs do resultado. Máximos, contagens e
+// somas ficam em registradores por lane e só são reduzidos no fim do bloco.
+inline void verify_range(const float* expected, const float* actual, size_t start, size_t end,
+                         uint32_t max_ulps, float abs_tolerance, VerifyPartial& partial) {
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256i unsigned_bias = _mm256_set1_epi32(INT32_MIN);
+    const __m256i biased_limit = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(max_ulps)), unsigned_bias);
+    const __m256 abs_limit = _mm256_set1_ps(abs_tolerance);
+
+    __m256i lane_max = _mm256_setzero_si256();    // Maior ULP de cada lane
+    __m256i lane_block = _mm256_setzero_si256();  // Bloco de 8 em que ele ocorreu
+    __m256i block = _mm256_setzero_si256();
+    __m256i lane_mismatches = _mm256_setzero_si256();
+    __m256i lane_nonzero = _mm256_setzero_si256();
+    __m256 lane_abs_max = _mm256_setzero_ps();
+    __m256d relative_sum = _mm256_setzero_pd();
+
+    const size_t blocks = (end - start) / 8;
+    for (size_t first = 0; first < blocks; first += VERIFY_FLUSH_BLOCKS) {
+        const size_t last = std::min(blocks, first + VERIFY_FLUSH_BLOCKS);
+        __m256 relative = _mm256_setzero_ps();
+        for (size_t k = first; k < last; k++) {
+            const size_t i = start + k * 8;
+            __m256 e = _mm256_loadu_ps(expected + i);
+            __m256 a = _mm256_loadu_ps(actual + i);
+
+            __m256i oe = ordered_float_bits(e), oa = ordered_float_bits(a);
+            __m256i ulps = _mm256_sub_epi32(_mm256_max_epi32(oe, oa), _mm256_min_epi32(oe, oa));
+            ulps = _mm256_or_si256(ulps, _mm256_castps_si256(_mm256_cmp_ps(e, a, _CMP_UNORD_Q)));
+            __m256i biased = _mm256_xor_si256(ulps, unsigned_bias);
+
+            __m256i improved = _mm256_cmpgt_epi32(biased, _mm256_xor_si256(lane_max, unsigned_bias));
+            lane_max = _mm256_max_epu32(lane_max, ulps);
+            lane_block = _mm256_blendv_epi8(lane_block, block, improved);
+            block = _mm256_sub_epi32(block, _mm256_set1_epi32(-1));
+
+            __m256 abs_error = _mm256_andnot_ps(sign_mask, _mm256_sub_ps(a, e));
+            lane_abs_max = _mm256_max_ps(lane_abs_max, abs_error);
+            __m256 over_abs = _mm256_cmp_ps(abs_error, abs_limit, _CMP_NLE_UQ);
+            __m256i bad = _mm256_and_si256(_mm256_cmpgt_epi32(biased, biased_limit), _mm256_castps_si256(over_abs));
+            lane_mismatches = _mm256_sub_epi32(lane_mismatches, bad);
+
+            // Erro relativo, ignorando esperado == 0
+            __m256 nonzero = _mm256_cmp_ps(e, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+            relative = _mm256_add_ps(relative, _mm256_and_ps(nonzero,
+                _mm256_div_ps(abs_error, _mm256_andnot_ps(sign_mask, e))));
+            lane_nonzero = _mm256_sub_epi32(lane_nonzero, _mm256_castps_si256(nonzero));
+        }
+        relative_sum = _mm256_add_pd(relative_sum, _mm256_cvtps_pd(_mm256_castps256_ps128(relative)));
+        relative_sum = _mm256_add_pd(relative_sum, _mm256_cvtps_pd(_mm256_extractf128_ps(relative, 1)));
+    }
+
+    alignas(32) uint32_t maxes[8], block_ids[8], mismatches[8], nonzeros[8];
+    alignas(32) float abs_maxes[8];
+    alignas(32) double sums[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxes), lane_max);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block_ids), lane_block);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mismatches), lane_mismatches);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(nonzeros), lane_nonzero);
+    _mm256_store_ps(abs_maxes, lane_abs_max);
+    _mm256_store_pd(sums, relative_sum);
+
+    // Lanes em ordem de posição para que empates fiquem com o primeiro elemento
+    for (int lane = 0; lane < 8; lane++) {
+        partial.mismatches += mismatches[lane];
+        partial.relative_count += nonzeros[lane];
+        partial.max_abs_error = std::max(partial.max_abs_error, abs_maxes[lane]);
+        const size_t index = start + static_cast<size_t>(block_ids[lane]) * 8 + lane;
+        if (maxes[lane] > partial.max_ulp ||
+            (maxes[lane] == partial.max_ulp && maxes[lane] > 0 && index < partial.max_ulp_index)) {
+            partial.max_ulp = maxes[lane];
+            partial.max_ulp_index = index;
+        }
+    }
+    partial.relative_sum += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+
+    for (size_t i = start + blocks * 8; i < end; ++i) {
+        uint32_t ulps = ulp_distance(expected[i], actual[i]);
+        float abs_error = std::abs(actual[i] - expected[i]);
+        if (ulps > max_ulps && !(abs_error <= abs_tolerance)) partial.mismatches++;
+        partial.max_abs_error = std::max(partial.max_abs_error, abs_error);
+        if (ulps > partial.max_ulp) {
+            partial.max_ulp = ulps;
+            partial.max_ulp_index = i;
+        }
+        if (expected[i] != 0.0f) {
+            partial.relative_sum += abs_error / std::abs(expected[i]);
+            partial.relative_count++;
+        }
+    }
+}
+
+// Distância em ULPs entre doubles, limitada a UINT32_MAX - 1 (UINT32_MAX indica NaN)
+inline uint32_t ulp_distance(double expected, double actual) {
+    if (std::isnan(expected) || std::isnan(actual)) return UINT32_MAX;
+    auto ordered = [](double value) {
+        int64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? static_cast<int64_t>(static_cast<uint64_t>(INT64_MIN) - static_cast<uint64_t>(bits)) : bits;
+    };
+    int64_t a = ordered(expected), b = ordered(actual);
+    const uint64_t distance = a > b ? static_cast<uint64_t>(a) - static_cast<uint64_t>(b)
+                                    : static_cast<uint64_t>(b) - static_cast<uint64_t>(a);
+    return static_cast<uint32_t>(std::min<uint64_t>(distance, UINT32_MAX - 1));
+}
+
+// Mesmos critérios de verify_range para double, em escalar
+inline void verify_range(const double* expected, const double* actual, size_t start, size_t end,
+                         uint32_t max_ulps, float abs_tolerance, VerifyPartial& partial) {
+    for (size_t i = start; i < end; ++i) {
+        uint32_t ulps = ulp_distance(expected[i], actual[i]);
+        double abs_error = std::abs(actual[i] - expected[i]);
+        if (ulps > max_ulps && !(abs_error <= abs_tolerance)) partial.mismatches++;
+        partial.max_abs_error = std::max(partial.max_abs_error, static_cast<float>(abs_error));
+        if (ulps > partial.max_ulp) {
+            partial.max_ulp = ulps;
+            partial.max_ulp_index = i;
+        }
+        if (expected[i] != 0.0) {
+            partial.relative_sum += abs_error / std::abs(expected[i]);
+            partial.relative_count++;
+        }
+    }
+}
+
+// Comparar actual com expected (float ou double) em paralelo; os parciais de cada bloco
+// são combinados na ordem dos blocos, então o resultado não depende do escalonamento
+template<typename T>
+VerifyResult verify_buffers(const T* expected, const T* actual, size_t size,
+                            uint32_t max_ulps, float abs_tolerance, int num_threads) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    size_t first_start, chunk_size;
+    thread_chunk(size, num_threads, 0, first_start, chunk_size);
+    std::vector<VerifyPartial> partials(num_threads);
+    for_each_thread_chunk(size, num_threads, [&](size_t start, size_t end) {
+        verify_range(expected, actual, start, end, max_ulps, abs_tolerance, partials[start / chunk_size]);
+    });
+
+    VerifyResult result;
+    result.count = size;
+    double relative_sum = 0.0;
+    size_t relative_count = 0;
+    for (const VerifyPartial& partial : partials) {
+        result.mismatches += partial.mismatches;
+        if (partial.max_ulp > result.max_ulp) {
+            result.max_ulp = partial.max_ulp;
+            result.max_ulp_index = partial.max_ulp_index;
+        }
+        relative_sum += partial.relative_sum;
+        relative_count += partial.relative_count;
+        result.max_abs_error = std::max(result.max_abs_error, partial.max_abs_error);
+    }
+    result.mean_relative_error = relative_count > 0 ? relative_sum / relative_count : 0.0;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.seconds = std::chrono::duration<double>(end_time - start_time).count();
+    return result;
+}
+
+template<typename Vector>
+VerifyResult verify_buffers(const Vector& expected, const Vector& actual, uint32_t max_ulps,
+                            float abs_tolerance, int num_threads) {
+    return verify_buffers(expected.data(), actual.data(), expected.size(), max_ulps, abs_tolerance, num_threads);
+}
+
+// Uma linha de resumo: "SIMD: erro máx 1 ULP (posição 42), erro relativo médio 3e-08, 0 divergências"
+inline void print_verification(const std::string& name, const VerifyResult& result) {
+    std::cout << name << ": erro máx ";
+    if (result.max_ulp == UINT32_MAX) {
+        std::cout << "NaN";
+    } else {
+        std::cout << result.max_ulp << " ULP";
+    }
+    std::cout << " (posição " << result.max_ulp_index << "), erro relativo médio "
+              << result.mean_relative_error << ", " << result.mismatches << " divergências de "
+              << result.count << " (" << result.seconds * 1000 << " ms)" << std::endl;
+}
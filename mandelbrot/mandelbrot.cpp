@@ -6,15 +6,96 @@
 #include <thread>
 #include <immintrin.h> // Para AVX2
 #include <cmath>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <quadmath.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
 
-// Configurações
-const int WIDTH = 800;
-const int HEIGHT = 800;
-const int MAX_ITERATIONS = 1000;
-const double X_MIN = -2.0;
-const double X_MAX = 1.0;
-const double Y_MIN = -1.5;
-const double Y_MAX = 1.5;
+#include "../common/thread_pool.h"
+#include "../common/roofline.h"
+#include "../common/perf_counters.h"
+#include "../common/benchmark.h"
+#include "../common/simd.h"
+
+#ifdef HAVE_ISPC
+#include "mandelbrot_ispc.h"
+#endif
+
+// Parâmetros de uma renderização: resolução, iterações e região do plano complexo
+struct RenderParams {
+    int width = 800;
+    int height = 800;
+    int max_iterations = 1000;
+    double x_min = -2.0;
+    double x_max = 1.0;
+    double y_min = -1.5;
+    double y_max = 1.5;
+    
+    // Tamanho do pixel calculado antes de somar o centro; em zoom profundo
+    // x_max - x_min sofre cancelamento e não serve para a perturbação
+    double pixel_size = 3.0 / 800;
+    
+    // Centro da vista como double-double (hi + lo) para o kernel de precisão estendida
+    double center_x_hi = -0.5, center_x_lo = 0.0;
+    double center_y_hi = 0.0, center_y_lo = 0.0;
+    
+    double x_scale() const { return (x_max - x_min) / width; }
+    double y_scale() const { return (y_max - y_min) / height; }
+};
+
+// Largura da vista no plano complexo com zoom 1
+const double BASE_VIEW_WIDTH = 3.0;
+
+// Quadros em voo no pipeline da sequência de zoom
+const int PIPELINE_DEPTH = 3;
+
+// Configurações do escalonador dinâmico
+const int TILE_WIDTH = 64;
+const int TILE_HEIGHT = 16;
+const int INTERLEAVE_TASKS_PER_THREAD = 8;
+
+// Precisão simples só é usada se o espaçamento entre pixels for maior que
+// FLOAT_SPACING_FACTOR * FLT_EPSILON * magnitude das coordenadas do tile
+const double FLOAT_SPACING_FACTOR = 256.0;
+
+// Retângulos menores que isso são calculados diretamente na subdivisão
+const int SUBDIVISION_MIN_SIZE = 16;
+
+// Cache de tiles para pan/zoom incremental: lado dos tiles (pixels) e orçamento padrão (MiB)
+const int CACHE_TILE_SIZE = 64;
+const size_t TILE_CACHE_BUDGET_MB = 64;
+
+// Medição do custo de despacho: chamadas repetidas e lado da imagem pequena
+const int DISPATCH_CALLS = 200;
+const int DISPATCH_RENDER_SIZE = 64;
+
+// Limite de --min-time por instanciação na matriz de kernels (são 12 a 18 instanciações)
+const double MATRIX_MIN_TIME = 0.1;
+
+// Trabalho para o roofline: FLOPs em double por iteração de z = z^2 + c com o teste de
+// escape (zx^2, zy^2, |z|^2, zx^2 - zy^2 + cx, 2 zx zy + cy) e bytes por pixel (o contador
+// gravado). Com milhares de FLOPs por byte o teto é sempre o pico de cálculo.
+const double MANDELBROT_FLOPS_PER_ITERATION = 8.0;
+const double MANDELBROT_BYTES_PER_PIXEL = sizeof(int);
 
 // Estrutura para armazenar dados de tempo
 struct TimingData {
@@ -22,196 +103,2422 @@ struct TimingData {
     double simd_time;
     double threaded_time;
     double simd_threaded_time;
+    double serial_earlyout_time;
+    double simd_earlyout_time;
+    double simd_threaded_earlyout_time;
+    PerfSample serial_counters;  // Contadores de hardware das quatro versões principais
+    PerfSample simd_counters;
+    PerfSample threaded_counters;
+    PerfSample simd_threaded_counters;
+};
+
+// Formatos de tile suportados pelo escalonador
+enum class TileShape {
+    ROWS,        // Faixas de TILE_HEIGHT linhas com largura total
+    TILES_2D,    // Blocos TILE_WIDTH x TILE_HEIGHT
+    INTERLEAVED  // Linhas intercaladas: y, y + passo, y + 2*passo, ...
+};
+
+// Região da imagem processada por uma tarefa (linhas y0, y0 + y_step, ... < y1)
+struct Tile {
+    int x0, x1;
+    int y0, y1;
+    int y_step;
+};
+
+// Contadores de ocupação das lanes SIMD, contados dentro dos kernels
+struct LaneStats {
+    std::atomic<uint64_t> useful_iterations{0};  // Iterações de pixels reais
+    std::atomic<uint64_t> lane_iterations{0};    // Passos do laço vetorial x lanes
+    
+    double utilization() const {
+        return lane_iterations > 0 ? static_cast<double>(useful_iterations) / lane_iterations : 0.0;
+    }
+};
+
+// Iterar Unroll vetores de pontos c = cx + i*cy até todas as lanes válidas escaparem ou
+// max_iterations. Os contadores são inteiros de 32 bits, um por lane, e avançam por soma
+// mascarada; lanes fora de valid nunca contam. Devolve o número
+// de passos do laço vetorial, em que as S::lanes * Unroll lanes estão ocupadas.
+template<typename T, Isa I, int Unroll = 1>
+int mandelbrot_iterate(const typename Simd<T, I>::Vec (&cx)[Unroll], const typename Simd<T, I>::Vec (&cy)[Unroll],
+                        const typename Simd<T, I>::Mask (&valid)[Unroll], int max_iterations,
+                        typename Simd<T, I>::Counter (&iters)[Unroll]) {
+    using S = Simd<T, I>;
+    using Vec = typename S::Vec;
+    const Vec four = S::set1(T(4));
+    const Vec two = S::set1(T(2));
+    
+    Vec zx[Unroll], zy[Unroll];
+    for (int u = 0; u < Unroll; u++) {
+        zx[u] = S::zero();
+        zy[u] = S::zero();
+        iters[u] = S::counter_zero();
+    }
+    
+    // O limite de iterações é testado junto com o escape, como no laço while escalar
+    for (int i = 0;; i++) {
+        // Calcular zx^2 e zy^2 e verificar condição de escape
+        Vec zx2[Unroll], zy2[Unroll];
+        typename S::Mask active[Unroll];
+        bool any_active = false;
+        for (int u = 0; u < Unroll; u++) {
+            zx2[u] = S::mul(zx[u], zx[u]);
+            zy2[u] = S::mul(zy[u], zy[u]);
+            active[u] = S::both(S::less(S::add(zx2[u], zy2[u]), four), valid[u]);
+            any_active |= S::any(active[u]);
+        }
+        
+        // Se todos escaparam, sair
+        if (!any_active || i == max_iterations) return i;
+        
+        for (int u = 0; u < Unroll; u++) {
+            // Atualizar contadores de iteração
+            iters[u] = S::counter_increment(iters[u], active[u]);
+            
+            // Calcular novo z; zy = 2 (zx zy) + cy como no kernel AVX2 original. O produto por
+            // 2 é exato, então o resultado é o mesmo com ou sem contração em FMA e todas as
+            // instanciações arredondam igual
+            const Vec new_zx = S::add(S::sub(zx2[u], zy2[u]), cx[u]);
+            zy[u] = S::add(S::mul(two, S::mul(zx[u], zy[u])), cy[u]);
+            zx[u] = new_zx;
+        }
+    }
+}
+
+// Calcular um único ponto (usado pela versão serial e pelas sobras do SIMD)
+inline int mandelbrot_point(double cx, double cy, int max_iterations) {
+    int32_t iters[1];
+    mandelbrot_iterate<double, Isa::SCALAR>({cx}, {cy}, {true}, max_iterations, iters);
+    return iters[0];
+}
+
+// Tile com a instanciação <T, I, Unroll>: Unroll vetores de pixels consecutivos da linha
+// por vez, com o fim da linha coberto por máscara (larguras quaisquer). Em float as
+// coordenadas são arredondadas do double, o que limita o zoom (float_precision_sufficient).
+// Com stats, soma as iterações dos pixels e as lanes de cada passo do laço vetorial.
+template<typename T, Isa I, int Unroll = 1>
+void mandelbrot_tile_lanes(std::vector<int>& iterations, const RenderParams& params, const Tile& tile,
+                           LaneStats* stats) {
+    uint64_t useful = 0, lane_iterations = 0;
+    using S = Simd<T, I>;
+    double x_scale = params.x_scale();
+    double y_scale = params.y_scale();
+    const typename S::Vec lane_index = S::iota();
+
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        typename S::Vec cy[Unroll];
+        for (int u = 0; u < Unroll; u++) {
+            cy[u] = S::set1(static_cast<T>(params.y_min + y * y_scale));
+        }
+        
+        for (int x = tile.x0; x < tile.x1; x += S::lanes * Unroll) {
+            typename S::Vec cx[Unroll];
+            typename S::Counter iters[Unroll];
+            typename S::Mask valid[Unroll];
+            for (int u = 0; u < Unroll; u++) {
+                const int xu = x + u * S::lanes;
+                alignas(64) T cx_vals[S::lanes];
+                for (int k = 0; k < S::lanes; k++) {
+                    cx_vals[k] = static_cast<T>(params.x_min + (xu + k) * x_scale);
+                }
+                cx[u] = S::load(cx_vals);
+                
+                // Lanes válidas: xu + k < x1
+                valid[u] = S::less(lane_index, S::set1(static_cast<T>(tile.x1 - xu)));
+            }
+            
+            const int steps = mandelbrot_iterate<T, I, Unroll>(cx, cy, valid, params.max_iterations, iters);
+            lane_iterations += static_cast<uint64_t>(steps) * S::lanes * Unroll;
+            
+            // Armazenar resultados
+            for (int u = 0; u < Unroll; u++) {
+                const int xu = x + u * S::lanes;
+                int32_t counts[S::lanes];
+                S::counter_store(counts, iters[u]);
+                for (int k = 0; k < S::lanes && xu + k < tile.x1; k++) {
+                    iterations[y * params.width + xu + k] = counts[k];
+                    useful += counts[k];
+                }
+            }
+        }
+    }
+    
+    if (stats) {
+        stats->useful_iterations += useful;
+        stats->lane_iterations += lane_iterations;
+    }
+}
+
+// Tile com a instanciação <T, I, Unroll>, sem contar a ocupação das lanes
+template<typename T, Isa I, int Unroll = 1>
+void mandelbrot_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    mandelbrot_tile_lanes<T, I, Unroll>(iterations, params, tile, nullptr);
+}
+
+// Versão serial básica sobre um tile
+void mandelbrot_serial_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    mandelbrot_tile<double, Isa::SCALAR>(iterations, params, tile);
+}
+
+// Versão serial básica
+void mandelbrot_serial(std::vector<int>& iterations, const RenderParams& params, int start_y, int end_y) {
+    mandelbrot_serial_tile(iterations, params, Tile{0, params.width, start_y, end_y, 1});
+}
+
+// Versão com AVX2 (SIMD) sobre um tile: 4 pontos em double por vez
+void mandelbrot_simd_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    mandelbrot_tile<double, Isa::AVX2>(iterations, params, tile);
+}
+
+// Versão com AVX2 sobre uma lista arbitrária de pixels (índices y * largura + x)
+void mandelbrot_simd_points(std::vector<int>& iterations, const RenderParams& params,
+                            const int* pixels, int count) {
+    double x_scale = params.x_scale();
+    double y_scale = params.y_scale();
+    const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        double cx_vals[4], cy_vals[4];
+        for (int k = 0; k < 4; k++) {
+            cx_vals[k] = params.x_min + (pixels[i + k] % params.width) * x_scale;
+            cy_vals[k] = params.y_min + (pixels[i + k] / params.width) * y_scale;
+        }
+        __m128i iters[1];
+        mandelbrot_iterate<double, Isa::AVX2>({_mm256_loadu_pd(cx_vals)}, {_mm256_loadu_pd(cy_vals)}, {all_lanes},
+                                              params.max_iterations, iters);
+        
+        int32_t result[4];
+        Simd<double, Isa::AVX2>::counter_store(result, iters[0]);
+        
+        for (int k = 0; k < 4; k++) {
+            iterations[pixels[i + k]] = result[k];
+        }
+    }
+    
+    for (; i < count; i++) {
+        iterations[pixels[i]] = mandelbrot_point(params.x_min + (pixels[i] % params.width) * x_scale,
+                                                 params.y_min + (pixels[i] / params.width) * y_scale,
+                                                 params.max_iterations);
+    }
+}
+
+// Versão com AVX2 (SIMD)
+void mandelbrot_simd(std::vector<int>& iterations, const RenderParams& params, int start_y, int end_y) {
+    mandelbrot_simd_tile(iterations, params, Tile{0, params.width, start_y, end_y, 1});
+}
+
+// Versão AVX2 em precisão simples: 8 pontos por vez
+void mandelbrot_simd_float_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    mandelbrot_tile<float, Isa::AVX2>(iterations, params, tile);
+}
+
+#ifdef __AVX512F__
+// Versão AVX-512 em precisão simples: 16 pontos por vez
+void mandelbrot_avx512_float_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    mandelbrot_tile<float, Isa::AVX512>(iterations, params, tile);
+}
+#endif
+
+// Verificar se a precisão simples basta para o tile: o espaçamento entre
+// pixels precisa ficar bem acima do epsilon de float na escala das coordenadas
+bool float_precision_sufficient(const RenderParams& params, const Tile& tile) {
+    double x_scale = params.x_scale();
+    double y_scale = params.y_scale();
+    
+    double magnitude = 2.0; // |z| chega a 2 antes de escapar
+    magnitude = std::max(magnitude, std::abs(params.x_min + tile.x0 * x_scale));
+    magnitude = std::max(magnitude, std::abs(params.x_min + tile.x1 * x_scale));
+    magnitude = std::max(magnitude, std::abs(params.y_min + tile.y0 * y_scale));
+    magnitude = std::max(magnitude, std::abs(params.y_min + tile.y1 * y_scale));
+    
+    double spacing = std::min(x_scale, y_scale);
+    return spacing > FLOAT_SPACING_FACTOR * FLT_EPSILON * magnitude;
+}
+
+// Seleção automática por tile: float na maior largura disponível, ou double
+// quando o zoom se aproxima do limite de precisão de float
+void mandelbrot_auto_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    if (!float_precision_sufficient(params, tile)) {
+        mandelbrot_simd_tile(iterations, params, tile);
+        return;
+    }
+#ifdef __AVX512F__
+    mandelbrot_avx512_float_tile(iterations, params, tile);
+#else
+    mandelbrot_simd_float_tile(iterations, params, tile);
+#endif
+}
+
+// Versão AVX2 com recarga de lanes: assim que uma lane termina, o resultado é
+// gravado e o próximo pixel da fila do tile entra no lugar dela, mantendo as
+// 4 lanes ocupadas em vez de esperar o pixel mais lento do grupo.
+void mandelbrot_simd_refill_tile(std::vector<int>& iterations, const RenderParams& params,
+                                 const Tile& tile, LaneStats& stats) {
+    double x_scale = params.x_scale();
+    double y_scale = params.y_scale();
+    
+    // Fila de pixels da thread
+    std::vector<int> queue;
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        for (int x = tile.x0; x < tile.x1; x++) {
+            queue.push_back(y * params.width + x);
+        }
+    }
+    size_t next = 0;
+    
+    alignas(32) double cx[4] = {0.0}, cy[4] = {0.0}, zx[4] = {0.0}, zy[4] = {0.0};
+    alignas(16) int32_t it[4] = {0};
+    int pixel[4];
+    int active = 0;
+    
+    for (int k = 0; k < 4; k++) {
+        pixel[k] = -1;
+        if (next < queue.size()) {
+            pixel[k] = queue[next++];
+            cx[k] = params.x_min + (pixel[k] % params.width) * x_scale;
+            cy[k] = params.y_min + (pixel[k] / params.width) * y_scale;
+            active++;
+        }
+    }
+    
+    __m256d vcx = _mm256_load_pd(cx), vcy = _mm256_load_pd(cy);
+    __m256d vzx = _mm256_load_pd(zx), vzy = _mm256_load_pd(zy);
+    __m128i viters = _mm_load_si128((const __m128i*)it);
+    const __m128i ones = _mm_set1_epi32(1);
+    const __m128i max_iters = _mm_set1_epi32(params.max_iterations);
+    
+    uint64_t useful = 0, steps = 0;
+    
+    while (active > 0) {
+        __m256d zx2 = _mm256_mul_pd(vzx, vzx);
+        __m256d zy2 = _mm256_mul_pd(vzy, vzy);
+        
+        // Lane continua se não escapou e não atingiu o máximo
+        __m256d mag2 = _mm256_add_pd(zx2, zy2);
+        int run_mask = _mm256_movemask_pd(_mm256_cmp_pd(mag2, _mm256_set1_pd(4.0), _CMP_LT_OQ)) &
+                       _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(max_iters, viters)));
+        
+        if (run_mask != 0xF) {
+            // Alguma lane terminou: gravar o resultado e carregar o próximo pixel
+            _mm256_store_pd(cx, vcx);
+            _mm256_store_pd(cy, vcy);
+            _mm256_store_pd(zx, vzx);
+            _mm256_store_pd(zy, vzy);
+            _mm_store_si128((__m128i*)it, viters);
+            
+            for (int k = 0; k < 4; k++) {
+                if (run_mask & (1 << k)) continue;
+                
+                if (pixel[k] >= 0) {
+                    iterations[pixel[k]] = it[k];
+                    useful += it[k];
+                    active--;
+                }
+                
+                pixel[k] = -1;
+                cx[k] = cy[k] = zx[k] = zy[k] = 0.0;
+                it[k] = 0;
+                if (next < queue.size()) {
+                    pixel[k] = queue[next++];
+                    cx[k] = params.x_min + (pixel[k] % params.width) * x_scale;
+                    cy[k] = params.y_min + (pixel[k] / params.width) * y_scale;
+                    active++;
+                }
+            }
+            
+            vcx = _mm256_load_pd(cx);
+            vcy = _mm256_load_pd(cy);
+            vzx = _mm256_load_pd(zx);
+            vzy = _mm256_load_pd(zy);
+            viters = _mm_load_si128((const __m128i*)it);
+            continue;
+        }
+        
+        // Todas as lanes ativas: uma iteração completa
+        viters = _mm_add_epi32(viters, ones);
+        
+        __m256d new_zx = _mm256_add_pd(_mm256_sub_pd(zx2, zy2), vcx);
+        __m256d new_zy = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), 
+                                   _mm256_mul_pd(vzx, vzy)), vcy);
+        vzx = new_zx;
+        vzy = new_zy;
+        steps++;
+    }
+    
+    stats.useful_iterations += useful;
+    stats.lane_iterations += 4 * steps;
+}
+
+// Teste analítico: ponto dentro da cardioide principal ou do bulbo de período 2.
+// Esses pontos nunca escapam, então o resultado é sempre o máximo de iterações.
+inline bool in_cardioid_or_bulb(double cx, double cy) {
+    double xq = cx - 0.25;
+    double q = xq * xq + cy * cy;
+    if (q * (q + xq) <= 0.25 * cy * cy) return true;
+    double xb = cx + 1.0;
+    return xb * xb + cy * cy <= 0.0625;
+}
+
+// Ponto único com saída antecipada para o interior do conjunto.
+// A detecção de periodicidade (Brent) compara z com um valor salvo em
+// iterações potência de 2; só igualdade exata conta, então o número de
+// iterações dos pontos que escapam é idêntico ao de mandelbrot_point.
+inline int mandelbrot_point_earlyout(double cx, double cy, int max_iterations) {
+    if (in_cardioid_or_bulb(cx, cy)) return max_iterations;
+    
+    double zx = 0.0, zy = 0.0;
+    double saved_zx = 0.0, saved_zy = 0.0;
+    int next_check = 1;
+    int iter = 0;
+    while (zx * zx + zy * zy < 4.0 && iter < max_iterations) {
+        double temp = zx * zx - zy * zy + cx;
+        zy = 2.0 * (zx * zy) + cy;  // Mesmo arredondamento de mandelbrot_iterate
+        zx = temp;
+        iter++;
+        
+        // Órbita periódica: nunca escapa
+        if (zx == saved_zx && zy == saved_zy) return max_iterations;
+        if (iter == next_check) {
+            saved_zx = zx;
+            saved_zy = zy;
+            next_check *= 2;
+        }
+    }
+    return iter;
+}
+
+// Versão serial com saída antecipada sobre um tile
+void mandelbrot_serial_earlyout_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    double x_scale = params.x_scale();
+    double y_scale = params.y_scale();
+
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        double cy = params.y_min + y * y_scale;
+        for (int x = tile.x0; x < tile.x1; x++) {
+            double cx = params.x_min + x * x_scale;
+            iterations[y * params.width + x] = mandelbrot_point_earlyout(cx, cy, params.max_iterations);
+        }
+    }
+}
+
+// Versão serial com saída antecipada
+void mandelbrot_serial_earlyout(std::vector<int>& iterations, const RenderParams& params, int start_y, int end_y) {
+    mandelbrot_serial_earlyout_tile(iterations, params, Tile{0, params.width, start_y, end_y, 1});
+}
+
+// Versão AVX2 com saída antecipada sobre um tile
+void mandelbrot_simd_earlyout_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    double x_scale = params.x_scale();
+    double y_scale = params.y_scale();
+    
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256i ones = _mm256_set1_epi64x(1);
+    const __m256i max_iters = _mm256_set1_epi64x(params.max_iterations);
+
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        double cy = params.y_min + y * y_scale;
+        
+        int x = tile.x0;
+        for (; x + 4 <= tile.x1; x += 4) {
+            double cx_vals[4] = {
+                params.x_min + (x) * x_scale,
+                params.x_min + (x+1) * x_scale,
+                params.x_min + (x+2) * x_scale,
+                params.x_min + (x+3) * x_scale
+            };
+            __m256d cx = _mm256_loadu_pd(cx_vals);
+            __m256d const_cy = _mm256_set1_pd(cy);
+            
+            // Teste da cardioide e do bulbo para os 4 pontos
+            __m256d cy2 = _mm256_mul_pd(const_cy, const_cy);
+            __m256d xq = _mm256_sub_pd(cx, _mm256_set1_pd(0.25));
+            __m256d q = _mm256_add_pd(_mm256_mul_pd(xq, xq), cy2);
+            __m256d in_cardioid = _mm256_cmp_pd(
+                _mm256_mul_pd(q, _mm256_add_pd(q, xq)),
+                _mm256_mul_pd(_mm256_set1_pd(0.25), cy2), _CMP_LE_OQ);
+            __m256d xb = _mm256_add_pd(cx, _mm256_set1_pd(1.0));
+            __m256d in_bulb = _mm256_cmp_pd(
+                _mm256_add_pd(_mm256_mul_pd(xb, xb), cy2),
+                _mm256_set1_pd(0.0625), _CMP_LE_OQ);
+            
+            // Lanes já classificadas como interiores
+            __m256d interior = _mm256_or_pd(in_cardioid, in_bulb);
+            
+            __m256i iters = _mm256_setzero_si256();
+            
+            if (_mm256_movemask_pd(interior) != 0xF) {
+                __m256d zx = _mm256_setzero_pd();
+                __m256d zy = _mm256_setzero_pd();
+                __m256d saved_zx = _mm256_setzero_pd();
+                __m256d saved_zy = _mm256_setzero_pd();
+                int next_check = 1;
+                
+                for (int i = 0; i < params.max_iterations; i++) {
+                    __m256d zx2 = _mm256_mul_pd(zx, zx);
+                    __m256d zy2 = _mm256_mul_pd(zy, zy);
+                    
+                    // Lanes ativas: ainda não escaparam e não são interiores
+                    __m256d mag2 = _mm256_add_pd(zx2, zy2);
+                    __m256d escape_mask = _mm256_cmp_pd(mag2, four, _CMP_LT_OQ);
+                    __m256d active = _mm256_andnot_pd(interior, escape_mask);
+                    
+                    if (_mm256_movemask_pd(active) == 0) break;
+                    
+                    __m256i mask = _mm256_castpd_si256(active);
+                    iters = _mm256_add_epi64(iters, _mm256_and_si256(mask, ones));
+                    
+                    __m256d new_zx = _mm256_add_pd(_mm256_sub_pd(zx2, zy2), cx);
+                    __m256d new_zy = _mm256_add_pd(_mm256_mul_pd(two, 
+                                               _mm256_mul_pd(zx, zy)), const_cy);
+                    
+                    zx = new_zx;
+                    zy = new_zy;
+                    
+                    // Periodicidade (Brent): z repetiu exatamente um valor salvo
+                    __m256d same = _mm256_and_pd(_mm256_cmp_pd(zx, saved_zx, _CMP_EQ_OQ),
+                                                 _mm256_cmp_pd(zy, saved_zy, _CMP_EQ_OQ));
+                    interior = _mm256_or_pd(interior, _mm256_and_pd(same, active));
+                    
+                    if (i + 1 == next_check) {
+                        saved_zx = zx;
+                        saved_zy = zy;
+                        next_check *= 2;
+                    }
+                }
+            }
+            
+            // Lanes interiores recebem o máximo de iterações
+            iters = _mm256_castpd_si256(_mm256_blendv_pd(
+                _mm256_castsi256_pd(iters), _mm256_castsi256_pd(max_iters), interior));
+            
+            int64_t result[4];
+            _mm256_storeu_si256((__m256i*)result, iters);
+            
+            for (int i = 0; i < 4; i++) {
+                iterations[y * params.width + x + i] = result[i];
+            }
+        }
+        
+        for (; x < tile.x1; x++) {
+            iterations[y * params.width + x] = mandelbrot_point_earlyout(params.x_min + x * x_scale, cy,
+                                                                       params.max_iterations);
+        }
+    }
+}
+
+// Versão AVX2 com saída antecipada
+void mandelbrot_simd_earlyout(std::vector<int>& iterations, const RenderParams& params, int start_y, int end_y) {
+    mandelbrot_simd_earlyout_tile(iterations, params, Tile{0, params.width, start_y, end_y, 1});
+}
+
+#ifdef HAVE_ISPC
+// Versão gerada pelo ISPC (foreach ao longo de cada linha)
+void mandelbrot_ispc(std::vector<int>& iterations, const RenderParams& params, int start_y, int end_y) {
+    ispc::mandelbrot_ispc(params.x_min, params.y_min, params.x_scale(), params.y_scale(), params.width,
+                          start_y, end_y, params.max_iterations, iterations.data());
+}
+
+// Versão gerada pelo ISPC com a imagem dividida em num_tasks faixas (launch)
+void mandelbrot_ispc_tasks(std::vector<int>& iterations, const RenderParams& params, int num_tasks) {
+    ispc::mandelbrot_ispc_tasks(params.x_min, params.y_min, params.x_scale(), params.y_scale(),
+                                params.width, params.height, params.max_iterations, iterations.data(),
+                                num_tasks);
+}
+#endif
+
+// Número de alta precisão para a órbita de referência (113 bits de mantissa)
+using HighPrecision = __float128;
+
+// Órbita de referência da perturbação, arredondada para double.
+// Contém Z_0 = 0 até a iteração em que a referência escapa (inclusive) ou o máximo.
+struct ReferenceOrbit {
+    std::vector<double> zx, zy;
+};
+
+// Calcular a órbita de referência no centro da vista em alta precisão
+ReferenceOrbit compute_reference_orbit(HighPrecision center_x, HighPrecision center_y,
+                                       int max_iterations) {
+    ReferenceOrbit orbit;
+    HighPrecision zx = 0, zy = 0;
+    
+    for (int i = 0; i <= max_iterations; i++) {
+        orbit.zx.push_back(static_cast<double>(zx));
+        orbit.zy.push_back(static_cast<double>(zy));
+        if (zx * zx + zy * zy >= 4) break;
+        
+        HighPrecision temp = zx * zx - zy * zy + center_x;
+        zy = 2 * zx * zy + center_y;
+        zx = temp;
+    }
+    
+    return orbit;
+}
+
+// Contadores de rebase da perturbação
+struct PerturbationStats {
+    std::atomic<uint64_t> rebases{0};   // Trocas para o início da referência
+    std::atomic<uint64_t> glitches{0};  // Rebases disparados pelo critério de glitch
+};
+
+// Critério de glitch (Pauldelbrot): |z|^2 < GLITCH_TOLERANCE * |Z|^2
+const double GLITCH_TOLERANCE = 1e-6;
+
+// Ponto único por perturbação: z = Z_m + dz, com dz iterado em double.
+// Quando |z| < |dz|, quando o critério de glitch dispara ou quando a
+// referência acaba, dz recebe z e a órbita recomeça em m = 0 (rebase).
+inline int perturbation_point(double dcx, double dcy, const ReferenceOrbit& orbit,
+                              int max_iterations, uint64_t& rebases, uint64_t& glitches) {
+    const int last = static_cast<int>(orbit.zx.size()) - 1;
+    double dzx = 0.0, dzy = 0.0;
+    int m = 0;
+    int iter = 0;
+    
+    while (iter < max_iterations) {
+        double ref_x = orbit.zx[m], ref_y = orbit.zy[m];
+        double zx = ref_x + dzx, zy = ref_y + dzy;
+        double mag2 = zx * zx + zy * zy;
+        if (mag2 >= 4.0) break;
+        iter++;
+        
+        bool glitch = mag2 < GLITCH_TOLERANCE * (ref_x * ref_x + ref_y * ref_y);
+        if (glitch || mag2 < dzx * dzx + dzy * dzy || m == last) {
+            rebases++;
+            if (glitch) glitches++;
+            dzx = zx;
+            dzy = zy;
+            ref_x = ref_y = 0.0;
+            m = 0;
+        }
+        
+        // dz' = 2 Z dz + dz^2 + dc
+        double new_dzx = 2.0 * (ref_x * dzx - ref_y * dzy) + (dzx * dzx - dzy * dzy) + dcx;
+        double new_dzy = 2.0 * (ref_x * dzy + ref_y * dzx) + 2.0 * dzx * dzy + dcy;
+        dzx = new_dzx;
+        dzy = new_dzy;
+        m++;
+    }
+    
+    return iter;
+}
+
+// Versão AVX2 por perturbação sobre um tile. Enquanto as 4 lanes estão no
+// mesmo índice da referência, Z_m é lido com broadcast; após o primeiro rebase
+// cada lane segue seu próprio índice, lido com gather.
+void mandelbrot_perturbation_tile(std::vector<int>& iterations, const RenderParams& params,
+                                  const Tile& tile, const ReferenceOrbit& orbit,
+                                  PerturbationStats& stats) {
+    const double pixel_size = params.pixel_size;
+    const double* ref_zx = orbit.zx.data();
+    const double* ref_zy = orbit.zy.data();
+    
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d tolerance = _mm256_set1_pd(GLITCH_TOLERANCE);
+    const __m256i ones = _mm256_set1_epi64x(1);
+    const __m256i last = _mm256_set1_epi64x(static_cast<int64_t>(orbit.zx.size()) - 1);
+    
+    uint64_t rebases = 0, glitches = 0;
+
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        // Deslocamento em relação ao centro (ponto de referência)
+        double dcy_value = (y - params.height / 2.0) * pixel_size;
+        
+        int x = tile.x0;
+        for (; x + 4 <= tile.x1; x += 4) {
+            double dcx_vals[4];
+            for (int k = 0; k < 4; k++) {
+                dcx_vals[k] = (x + k - params.width / 2.0) * pixel_size;
+            }
+            __m256d dcx = _mm256_loadu_pd(dcx_vals);
+            __m256d dcy = _mm256_set1_pd(dcy_value);
+            
+            __m256d dzx = _mm256_setzero_pd();
+            __m256d dzy = _mm256_setzero_pd();
+            __m256i m = _mm256_setzero_si256();
+            __m256i iters = _mm256_setzero_si256();
+            __m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            int shared_m = 0;
+            bool synced = true;
+            
+            for (int i = 0; i < params.max_iterations; i++) {
+                __m256d ref_x, ref_y;
+                if (synced) {
+                    ref_x = _mm256_broadcast_sd(ref_zx + shared_m);
+                    ref_y = _mm256_broadcast_sd(ref_zy + shared_m);
+                } else {
+                    ref_x = _mm256_i64gather_pd(ref_zx, m, 8);
+                    ref_y = _mm256_i64gather_pd(ref_zy, m, 8);
+                }
+                __m256d zx = _mm256_add_pd(ref_x, dzx);
+                __m256d zy = _mm256_add_pd(ref_y, dzy);
+                
+                __m256d mag2 = _mm256_add_pd(_mm256_mul_pd(zx, zx), _mm256_mul_pd(zy, zy));
+                active = _mm256_and_pd(active, _mm256_cmp_pd(mag2, four, _CMP_LT_OQ));
+                
+                if (_mm256_movemask_pd(active) == 0) break;
+                
+                iters = _mm256_add_epi64(iters, _mm256_and_si256(_mm256_castpd_si256(active), ones));
+                
+                // Rebase: |z| < |dz|, glitch ou fim da referência
+                __m256d ref_mag2 = _mm256_add_pd(_mm256_mul_pd(ref_x, ref_x), _mm256_mul_pd(ref_y, ref_y));
+                __m256d dz_mag2 = _mm256_add_pd(_mm256_mul_pd(dzx, dzx), _mm256_mul_pd(dzy, dzy));
+                __m256d glitch = _mm256_cmp_pd(mag2, _mm256_mul_pd(tolerance, ref_mag2), _CMP_LT_OQ);
+                __m256d rebase = _mm256_or_pd(
+                    _mm256_or_pd(glitch, _mm256_cmp_pd(mag2, dz_mag2, _CMP_LT_OQ)),
+                    _mm256_castsi256_pd(_mm256_cmpeq_epi64(synced ? _mm256_set1_epi64x(shared_m) : m,
+                                                           last)));
+                rebase = _mm256_and_pd(rebase, active);
+                
+                int rebase_mask = _mm256_movemask_pd(rebase);
+                if (rebase_mask != 0) {
+                    if (synced) {
+                        m = _mm256_set1_epi64x(shared_m);
+                        synced = false;
+                    }
+                    rebases += _mm_popcnt_u32(rebase_mask);
+                    glitches += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_and_pd(glitch, rebase)));
+                    dzx = _mm256_blendv_pd(dzx, zx, rebase);
+                    dzy = _mm256_blendv_pd(dzy, zy, rebase);
+                    ref_x = _mm256_andnot_pd(rebase, ref_x);
+                    ref_y = _mm256_andnot_pd(rebase, ref_y);
+                    m = _mm256_andnot_si256(_mm256_castpd_si256(rebase), m);
+                }
+                
+                // dz' = 2 Z dz + dz^2 + dc
+                __m256d new_dzx = _mm256_add_pd(
+                    _mm256_mul_pd(two, _mm256_sub_pd(_mm256_mul_pd(ref_x, dzx), _mm256_mul_pd(ref_y, dzy))),
+                    _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(dzx, dzx), _mm256_mul_pd(dzy, dzy)), dcx));
+                __m256d new_dzy = _mm256_add_pd(
+                    _mm256_mul_pd(two, _mm256_add_pd(_mm256_mul_pd(ref_x, dzy), _mm256_mul_pd(ref_y, dzx))),
+                    _mm256_add_pd(_mm256_mul_pd(two, _mm256_mul_pd(dzx, dzy)), dcy));
+                dzx = new_dzx;
+                dzy = new_dzy;
+                
+                // Lanes encerradas param no último índice válido da referência
+                if (synced) {
+                    shared_m++;
+                } else {
+                    m = _mm256_add_epi64(m, _mm256_and_si256(_mm256_castpd_si256(active), ones));
+                }
+            }
+            
+            int64_t result[4];
+            _mm256_storeu_si256((__m256i*)result, iters);
+            
+            for (int k = 0; k < 4; k++) {
+                iterations[y * params.width + x + k] = result[k];
+            }
+        }
+        
+        for (; x < tile.x1; x++) {
+            iterations[y * params.width + x] = perturbation_point(
+                (x - params.width / 2.0) * pixel_size, dcy_value, orbit, params.max_iterations,
+                rebases, glitches);
+        }
+    }
+    
+    stats.rebases += rebases;
+    stats.glitches += glitches;
+}
+
+// Quatro números double-double (valor = hi + lo, ~106 bits de mantissa)
+struct DoubleDouble4 {
+    __m256d hi, lo;
+};
+
+// Soma exata: s + e == a + b (transformação sem erro de Knuth)
+inline void two_sum(__m256d a, __m256d b, __m256d& s, __m256d& e) {
+    s = _mm256_add_pd(a, b);
+    __m256d bb = _mm256_sub_pd(s, a);
+    e = _mm256_add_pd(_mm256_sub_pd(a, _mm256_sub_pd(s, bb)), _mm256_sub_pd(b, bb));
+}
+
+// Soma exata válida quando |a| >= |b|
+inline void quick_two_sum(__m256d a, __m256d b, __m256d& s, __m256d& e) {
+    s = _mm256_add_pd(a, b);
+    e = _mm256_sub_pd(b, _mm256_sub_pd(s, a));
+}
+
+// Produto exato com FMA: p + e == a * b
+inline void two_prod(__m256d a, __m256d b, __m256d& p, __m256d& e) {
+    p = _mm256_mul_pd(a, b);
+    e = _mm256_fmsub_pd(a, b, p);
+}
+
+inline DoubleDouble4 dd_add(DoubleDouble4 a, DoubleDouble4 b) {
+    __m256d s, e;
+    two_sum(a.hi, b.hi, s, e);
+    e = _mm256_add_pd(e, _mm256_add_pd(a.lo, b.lo));
+    DoubleDouble4 r;
+    quick_two_sum(s, e, r.hi, r.lo);
+    return r;
+}
+
+inline DoubleDouble4 dd_sub(DoubleDouble4 a, DoubleDouble4 b) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    return dd_add(a, DoubleDouble4{_mm256_xor_pd(b.hi, sign), _mm256_xor_pd(b.lo, sign)});
+}
+
+inline DoubleDouble4 dd_mul(DoubleDouble4 a, DoubleDouble4 b) {
+    __m256d p, e;
+    two_prod(a.hi, b.hi, p, e);
+    e = _mm256_fmadd_pd(a.hi, b.lo, e);
+    e = _mm256_fmadd_pd(a.lo, b.hi, e);
+    DoubleDouble4 r;
+    quick_two_sum(p, e, r.hi, r.lo);
+    return r;
+}
+
+inline DoubleDouble4 dd_sqr(DoubleDouble4 a) {
+    __m256d p, e;
+    two_prod(a.hi, a.hi, p, e);
+    e = _mm256_fmadd_pd(_mm256_add_pd(a.hi, a.hi), a.lo, e);
+    DoubleDouble4 r;
+    quick_two_sum(p, e, r.hi, r.lo);
+    return r;
+}
+
+// Iterar 4 pontos em double-double; mesmo laço de mandelbrot_iterate
+inline __m256i mandelbrot_iterate4_dd(DoubleDouble4 cx, DoubleDouble4 cy, int max_iterations) {
+    DoubleDouble4 zx{_mm256_setzero_pd(), _mm256_setzero_pd()};
+    DoubleDouble4 zy{_mm256_setzero_pd(), _mm256_setzero_pd()};
+    
+    __m256i iters = _mm256_setzero_si256();
+    __m256i ones = _mm256_set1_epi64x(1);
+    
+    for (int i = 0; i < max_iterations; i++) {
+        DoubleDouble4 zx2 = dd_sqr(zx);
+        DoubleDouble4 zy2 = dd_sqr(zy);
+        
+        // A parte alta basta para o teste de escape
+        __m256d mag2 = _mm256_add_pd(zx2.hi, zy2.hi);
+        __m256d escape_mask = _mm256_cmp_pd(mag2, _mm256_set1_pd(4.0), _CMP_LT_OQ);
+        if (_mm256_movemask_pd(escape_mask) == 0) break;
+        
+        __m256i mask = _mm256_castpd_si256(escape_mask);
+        iters = _mm256_add_epi64(iters, _mm256_and_si256(mask, ones));
+        
+        // Multiplicar por 2 é exato nas duas partes
+        DoubleDouble4 zxy = dd_mul(zx, zy);
+        zxy.hi = _mm256_add_pd(zxy.hi, zxy.hi);
+        zxy.lo = _mm256_add_pd(zxy.lo, zxy.lo);
+        
+        zx = dd_add(dd_sub(zx2, zy2), cx);
+        zy = dd_add(zxy, cy);
+    }
+    
+    return iters;
+}
+
+// Versão AVX2 em double-double para zooms entre o limite do double e o da perturbação.
+// As coordenadas são centro (hi + lo) + deslocamento * pixel_size, para não perder os
+// bits baixos do centro; a sobra da linha repete o último pixel e descarta as lanes extras.
+void mandelbrot_dd_tile(std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+    const double pixel_size = params.pixel_size;
+    const DoubleDouble4 center_x{_mm256_set1_pd(params.center_x_hi), _mm256_set1_pd(params.center_x_lo)};
+    
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        DoubleDouble4 cy{_mm256_set1_pd(params.center_y_hi), _mm256_set1_pd(params.center_y_lo)};
+        cy = dd_add(cy, DoubleDouble4{_mm256_set1_pd((y - params.height / 2.0) * pixel_size),
+                                      _mm256_setzero_pd()});
+        
+        for (int x = tile.x0; x < tile.x1; x += 4) {
+            int count = std::min(4, tile.x1 - x);
+            double offsets[4];
+            for (int k = 0; k < 4; k++) {
+                offsets[k] = (x + std::min(k, count - 1) - params.width / 2.0) * pixel_size;
+            }
+            DoubleDouble4 cx = dd_add(center_x, DoubleDouble4{_mm256_loadu_pd(offsets),
+                                                              _mm256_setzero_pd()});
+            
+            int64_t result[4];
+            _mm256_storeu_si256((__m256i*)result, mandelbrot_iterate4_dd(cx, cy, params.max_iterations));
+            
+            for (int k = 0; k < count; k++) {
+                iterations[y * params.width + x + k] = result[k];
+            }
+        }
+    }
+}
+
+// Versão double-double por faixa de linhas (para process_threaded)
+void mandelbrot_dd(std::vector<int>& iterations, const RenderParams& params, int start_y, int end_y) {
+    mandelbrot_dd_tile(iterations, params, Tile{0, params.width, start_y, end_y, 1});
+}
+
+// Função para processamento multi-thread: uma faixa de linhas por worker do pool
+template<typename Func>
+void process_threaded(std::vector<int>& iterations, const RenderParams& params, Func func,
+                      int num_threads) {
+    const int rows_per_thread = (params.height + num_threads - 1) / num_threads;
+    shared_thread_pool(num_threads).parallel_for(params.height, rows_per_thread, [&](size_t start_y, size_t end_y) {
+        func(iterations, params, static_cast<int>(start_y), static_cast<int>(end_y));
+    });
+}
+
+// Mesmas faixas, criando as threads a cada chamada (para medir o custo de despacho)
+template<typename Func>
+void process_threaded_spawn(std::vector<int>& iterations, const RenderParams& params, Func func,
+                            int num_threads) {
+    const int rows_per_thread = (params.height + num_threads - 1) / num_threads;
+    spawn_parallel_for(params.height, rows_per_thread, num_threads, [&](size_t start_y, size_t end_y) {
+        func(iterations, params, static_cast<int>(start_y), static_cast<int>(end_y));
+    });
+}
+
+// Dividir a imagem em tarefas conforme o formato de tile
+std::vector<Tile> make_tiles(const RenderParams& params, TileShape shape, int num_threads) {
+    std::vector<Tile> tiles;
+    
+    switch (shape) {
+        case TileShape::ROWS:
+            for (int y = 0; y < params.height; y += TILE_HEIGHT) {
+                tiles.push_back(Tile{0, params.width, y, std::min(y + TILE_HEIGHT, params.height), 1});
+            }
+            break;
+        case TileShape::TILES_2D:
+            for (int y = 0; y < params.height; y += TILE_HEIGHT) {
+                for (int x = 0; x < params.width; x += TILE_WIDTH) {
+                    tiles.push_back(Tile{x, std::min(x + TILE_WIDTH, params.width),
+                                         y, std::min(y + TILE_HEIGHT, params.height), 1});
+                }
+            }
+            break;
+        case TileShape::INTERLEAVED: {
+            int stride = std::min(params.height, num_threads * INTERLEAVE_TASKS_PER_THREAD);
+            for (int y = 0; y < stride; y++) {
+                tiles.push_back(Tile{0, params.width, y, params.height, stride});
+            }
+            break;
+        }
+    }
+    
+    return tiles;
+}
+
+const char* tile_shape_name(TileShape shape) {
+    switch (shape) {
+        case TileShape::ROWS: return "linhas";
+        case TileShape::TILES_2D: return "tiles 2D";
+        case TileShape::INTERLEAVED: return "linhas intercaladas";
+    }
+    return "?";
+}
+
+// Estatísticas por thread do escalonador dinâmico
+struct SchedulerStats {
+    std::vector<double> busy_time;  // Tempo dentro das tarefas (s)
+    std::vector<int> tasks_done;
+    std::vector<int> tasks_stolen;
+};
+
+// Fila de tarefas de um worker: o dono consome pelo fim, os ladrões pelo início
+template<typename Task>
+class alignas(64) WorkQueue {
+public:
+    void push(const Task& task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(task);
+    }
+    
+    bool pop(Task& task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) return false;
+        task = tasks_.back();
+        tasks_.pop_back();
+        return true;
+    }
+    
+    bool steal(Task& task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) return false;
+        task = tasks_.front();
+        tasks_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+};
+
+// Escalonador com roubo de trabalho (work stealing).
+// Tarefas podem criar novas tarefas com push() durante run(); a execução
+// termina quando não há mais tarefas pendentes em nenhuma fila.
+template<typename Task>
+class WorkStealingScheduler {
+public:
+    explicit WorkStealingScheduler(int num_workers) : queues_(num_workers) {}
+    
+    int num_workers() const { return static_cast<int>(queues_.size()); }
+    
+    void push(int worker, const Task& task) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        queues_[worker].push(task);
+    }
+    
+    // func(task, worker) é chamada para cada tarefa
+    template<typename Func>
+    SchedulerStats run(Func func) {
+        const int n = num_workers();
+        SchedulerStats stats;
+        stats.busy_time.assign(n, 0.0);
+        stats.tasks_done.assign(n, 0);
+        stats.tasks_stolen.assign(n, 0);
+        
+        // Uma fila por worker do pool compartilhado: o bloco w vai sempre para o worker w
+        shared_thread_pool(n).parallel_for(n, 1, [&](size_t first, size_t last) {
+            for (int w = static_cast<int>(first); w < static_cast<int>(last); w++) {
+                double busy = 0.0;
+                int done = 0, stolen = 0;
+                Task task;
+                
+                while (pending_.load(std::memory_order_acquire) > 0) {
+                    bool was_stolen = false;
+                    if (!next_task(w, task, was_stolen)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    
+                    auto start = std::chrono::high_resolution_clock::now();
+                    func(task, w);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    busy += std::chrono::duration<double>(end - start).count();
+                    done++;
+                    if (was_stolen) stolen++;
+                    
+                    pending_.fetch_sub(1, std::memory_order_acq_rel);
+                }
+                
+                stats.busy_time[w] = busy;
+                stats.tasks_done[w] = done;
+                stats.tasks_stolen[w] = stolen;
+            }
+        });
+
+        return stats;
+    }
+
+private:
+    bool next_task(int worker, Task& task, bool& stolen) {
+        if (queues_[worker].pop(task)) return true;
+        
+        const int n = num_workers();
+        for (int i = 1; i < n; i++) {
+            if (queues_[(worker + i) % n].steal(task)) {
+                stolen = true;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    std::vector<WorkQueue<Task>> queues_;
+    std::atomic<int> pending_{0};
+};
+
+// Processamento multi-thread com escalonamento dinâmico por tiles
+template<typename Func>
+SchedulerStats process_tiled(std::vector<int>& iterations, const RenderParams& params, Func func,
+                             int num_threads, TileShape shape) {
+    WorkStealingScheduler<Tile> scheduler(num_threads);
+    std::vector<Tile> tiles = make_tiles(params, shape, num_threads);
+    
+    // Distribuição inicial round-robin; o balanceamento fica a cargo do roubo
+    for (size_t i = 0; i < tiles.size(); i++) {
+        scheduler.push(i % num_threads, tiles[i]);
+    }
+    
+    return scheduler.run([&](const Tile& tile, int) {
+        func(iterations, params, tile);
+    });
+}
+
+// Exibir o tempo ocupado de cada thread e o desbalanceamento de carga
+void print_scheduler_stats(const SchedulerStats& stats, double wall_time) {
+    const int n = stats.busy_time.size();
+    double total = 0.0, max_busy = 0.0, min_busy = stats.busy_time[0];
+    for (int w = 0; w < n; w++) {
+        total += stats.busy_time[w];
+        max_busy = std::max(max_busy, stats.busy_time[w]);
+        min_busy = std::min(min_busy, stats.busy_time[w]);
+    }
+    double mean_busy = total / n;
+    
+    for (int w = 0; w < n; w++) {
+        std::cout << "  Thread " << w << ": ocupada " << stats.busy_time[w] << "s ("
+                  << (stats.busy_time[w] / wall_time) * 100 << "%), "
+                  << stats.tasks_done[w] << " tarefas, "
+                  << stats.tasks_stolen[w] << " roubadas" << std::endl;
+    }
+    std::cout << "  Tempo ocupado mín/médio/máx: " << min_busy << "s / "
+              << mean_busy << "s / " << max_busy << "s" << std::endl;
+    std::cout << "  Desbalanceamento (máx/médio): "
+              << (mean_busy > 0.0 ? max_busy / mean_busy : 1.0) << std::endl;
+}
+
+// Retângulo da subdivisão de Mariani–Silver (coordenadas inclusivas).
+// Invariante: a borda do retângulo já foi calculada quando a tarefa executa.
+struct SubdivisionRect {
+    int x0, y0;
+    int x1, y1;
+};
+
+// Calcular a borda de um retângulo: linhas pelo kernel de tile, colunas pela lista de pixels
+size_t compute_rect_border(std::vector<int>& iterations, const RenderParams& params,
+                           const SubdivisionRect& r) {
+    mandelbrot_simd_tile(iterations, params, Tile{r.x0, r.x1 + 1, r.y0, r.y0 + 1, 1});
+    mandelbrot_simd_tile(iterations, params, Tile{r.x0, r.x1 + 1, r.y1, r.y1 + 1, 1});
+    
+    std::vector<int> column;
+    for (int y = r.y0 + 1; y < r.y1; y++) {
+        column.push_back(y * params.width + r.x0);
+        column.push_back(y * params.width + r.x1);
+    }
+    mandelbrot_simd_points(iterations, params, column.data(), column.size());
+    
+    return 2 * (r.x1 - r.x0 + 1) + column.size();
+}
+
+// Verificar se toda a borda tem o mesmo número de iterações
+bool rect_border_uniform(const std::vector<int>& iterations, const RenderParams& params,
+                         const SubdivisionRect& r) {
+    const int value = iterations[r.y0 * params.width + r.x0];
+    for (int x = r.x0; x <= r.x1; x++) {
+        if (iterations[r.y0 * params.width + x] != value) return false;
+        if (iterations[r.y1 * params.width + x] != value) return false;
+    }
+    for (int y = r.y0 + 1; y < r.y1; y++) {
+        if (iterations[y * params.width + r.x0] != value) return false;
+        if (iterations[y * params.width + r.x1] != value) return false;
+    }
+    return true;
+}
+
+// Renderização por subdivisão de retângulos (Mariani–Silver).
+// Se a borda de um retângulo é uniforme, o interior é preenchido sem iterar;
+// caso contrário a cruz central é calculada e os 4 quadrantes viram novas
+// tarefas no escalonador. Devolve a fração de pixels efetivamente iterados.
+double mandelbrot_subdivide(std::vector<int>& iterations, const RenderParams& params, int num_threads,
+                            SchedulerStats& stats) {
+    WorkStealingScheduler<SubdivisionRect> scheduler(num_threads);
+    std::vector<size_t> iterated(num_threads, 0);
+    
+    SubdivisionRect root{0, 0, params.width - 1, params.height - 1};
+    size_t root_border = compute_rect_border(iterations, params, root);
+    scheduler.push(0, root);
+    
+    stats = scheduler.run([&](const SubdivisionRect& r, int worker) {
+        const int inner_w = r.x1 - r.x0 - 1;
+        const int inner_h = r.y1 - r.y0 - 1;
+        if (inner_w <= 0 || inner_h <= 0) return;
+        
+        if (rect_border_uniform(iterations, params, r)) {
+            const int value = iterations[r.y0 * params.width + r.x0];
+            for (int y = r.y0 + 1; y < r.y1; y++) {
+                std::fill(iterations.begin() + y * params.width + r.x0 + 1,
+                          iterations.begin() + y * params.width + r.x1, value);
+            }
+            return;
+        }
+        
+        // Folha: calcular o interior diretamente
+        if (inner_w <= SUBDIVISION_MIN_SIZE || inner_h <= SUBDIVISION_MIN_SIZE) {
+            mandelbrot_simd_tile(iterations, params, Tile{r.x0 + 1, r.x1, r.y0 + 1, r.y1, 1});
+            iterated[worker] += static_cast<size_t>(inner_w) * inner_h;
+            return;
+        }
+        
+        // Calcular a cruz central, que forma a borda dos 4 quadrantes
+        const int xm = (r.x0 + r.x1) / 2;
+        const int ym = (r.y0 + r.y1) / 2;
+        mandelbrot_simd_tile(iterations, params, Tile{r.x0 + 1, r.x1, ym, ym + 1, 1});
+        
+        std::vector<int> column;
+        for (int y = r.y0 + 1; y < r.y1; y++) {
+            if (y != ym) column.push_back(y * params.width + xm);
+        }
+        mandelbrot_simd_points(iterations, params, column.data(), column.size());
+        iterated[worker] += inner_w + column.size();
+        
+        scheduler.push(worker, SubdivisionRect{r.x0, r.y0, xm, ym});
+        scheduler.push(worker, SubdivisionRect{xm, r.y0, r.x1, ym});
+        scheduler.push(worker, SubdivisionRect{r.x0, ym, xm, r.y1});
+        scheduler.push(worker, SubdivisionRect{xm, ym, r.x1, r.y1});
+    });
+    
+    size_t total = root_border;
+    for (size_t count : iterated) {
+        total += count;
+    }
+    return static_cast<double>(total) / (static_cast<double>(params.width) * params.height);
+}
+
+// Tabela de cores: índice = número de iterações, 3 bytes RGB por entrada
+std::vector<unsigned char> build_palette(int max_iterations) {
+    std::vector<unsigned char> palette(3 * (max_iterations + 1));
+    
+    for (int iter = 0; iter <= max_iterations; iter++) {
+        // Mapear iterações para cores
+        unsigned char r, g, b;
+        if (iter == max_iterations) {
+            r = g = b = 0; // Preto para pontos no conjunto
+        } else {
+            // Esquema de cores simples
+            r = static_cast<unsigned char>((iter * 5) % 256);
+            g = static_cast<unsigned char>((iter * 7) % 256);
+            b = static_cast<unsigned char>((iter * 11) % 256);
+        }
+        palette[3 * iter] = r;
+        palette[3 * iter + 1] = g;
+        palette[3 * iter + 2] = b;
+    }
+    
+    return palette;
+}
+
+// Colorir um tile do buffer de iterações para RGB
+void colorize_tile(const std::vector<int>& iterations, std::vector<unsigned char>& rgb,
+                   const std::vector<unsigned char>& palette, const RenderParams& params,
+                   const Tile& tile) {
+    for (int y = tile.y0; y < tile.y1; y += tile.y_step) {
+        for (int x = tile.x0; x < tile.x1; x++) {
+            const int pixel = y * params.width + x;
+            const unsigned char* color = &palette[3 * iterations[pixel]];
+            rgb[3 * pixel] = color[0];
+            rgb[3 * pixel + 1] = color[1];
+            rgb[3 * pixel + 2] = color[2];
+        }
+    }
+}
+
+// Colorir a imagem inteira em paralelo
+void colorize_parallel(std::vector<int>& iterations, std::vector<unsigned char>& rgb,
+                       const std::vector<unsigned char>& palette, const RenderParams& params,
+                       int num_threads) {
+    process_tiled(iterations, params, [&](std::vector<int>& iters, const RenderParams& p,
+                                          const Tile& tile) {
+        colorize_tile(iters, rgb, palette, p, tile);
+    }, num_threads, TileShape::ROWS);
+}
+
+// Kernel que colore cada tile logo após calculá-lo, enquanto ele ainda está em cache
+template<typename Func>
+auto make_colorizing_kernel(Func kernel, std::vector<unsigned char>& rgb,
+                            const std::vector<unsigned char>& palette) {
+    return [kernel, &rgb, &palette](std::vector<int>& iterations, const RenderParams& params, const Tile& tile) {
+        kernel(iterations, params, tile);
+        colorize_tile(iterations, rgb, palette, params, tile);
+    };
+}
+
+// Gerar imagem PPM binária (P6) com uma única escrita
+void save_ppm(const std::vector<unsigned char>& rgb, const RenderParams& params,
+              const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    file << "P6\n" << params.width << " " << params.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+}
+
+// Medir tempo de execução
+template<typename Func>
+double measure_time(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Contar pixels com número de iterações diferente
+size_t count_mismatches(const std::vector<int>& a, const std::vector<int>& b) {
+    size_t count = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] != b[i]) count++;
+    }
+    return count;
+}
+
+// Total de iterações calculadas (para medir Miterações/s)
+double total_iterations(const std::vector<int>& iterations) {
+    double total = 0.0;
+    for (int iter : iterations) {
+        total += iter;
+    }
+    return total;
+}
+
+// Opções de linha de comando
+struct Options {
+    RenderParams params;
+    HighPrecision center_x = -0.5;  // Centro lido em alta precisão (double-double e perturbação)
+    HighPrecision center_y = 0.0;
+    double zoom = 1.0;
+    int num_threads = std::thread::hardware_concurrency();
+    std::string kernel = "simd";
+    TileShape shape = TileShape::TILES_2D;
+    bool render = false;
+    int frames = 0;
+    double zoom_step = 1.05;
+    std::string output = "mandelbrot";
+    size_t cache_budget_mb = TILE_CACHE_BUDGET_MB;
+    std::string serve_path;      // Socket do servidor de tiles (--serve)
+    std::string load_test_path;  // Socket alvo do gerador de carga (--load-test)
+    int load_clients = 8;
+};
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " [largura altura iterações] [opções]\n"
+              << "  --center X Y      centro da vista (padrão -0.5 0)\n"
+              << "  --zoom Z          zoom; a vista tem largura " << BASE_VIEW_WIDTH << "/Z (padrão 1)\n"
+              << "  --threads N       número de threads (padrão: todos os núcleos)\n"
+              << "  --kernel K        serial | simd | earlyout | float | auto | refill | subdivide |\n"
+              << "                    dd (double-double, zoom até ~1e28) |\n"
+              << "                    perturbation (zoom profundo, centro lido em alta precisão)\n"
+              << "  --tiles T         rows | tiles | interleaved (padrão tiles)\n"
+              << "  --render          renderiza uma única imagem com o kernel escolhido\n"
+              << "  --frames N        renderiza uma sequência de zoom com N quadros\n"
+              << "  --zoom-step F     fator de zoom entre quadros consecutivos (padrão 1.05)\n"
+              << "  --output PREFIXO  prefixo dos arquivos .ppm (padrão mandelbrot)\n"
+              << "  --cache-mb N      orçamento do cache de tiles no benchmark de pan/zoom (padrão "
+              << TILE_CACHE_BUDGET_MB << ")\n"
+              << "  --serve SOCKET    servidor de tiles em um socket Unix (encerra com Ctrl-C)\n"
+              << "  --load-test SOCKET gerador de carga contra o servidor, de 1 até --clients clientes\n"
+              << "  --clients N       número máximo de clientes do gerador de carga (padrão 8)\n"
+              << "  --warmup N        execuções de aquecimento das versões principais do benchmark (padrão 2)\n"
+              << "  --min-time S      segundos mínimos medidos por versão principal (padrão 0.5)\n"
+              << "Sem --render ou --frames, executa o benchmark comparativo." << std::endl;
+}
+
+// Ajustar a região do plano complexo a partir do centro e do zoom
+void set_view(RenderParams& params, HighPrecision center_x, HighPrecision center_y, double zoom) {
+    double span_x = BASE_VIEW_WIDTH / zoom;
+    double span_y = span_x * params.height / params.width;
+    params.x_min = static_cast<double>(center_x - span_x / 2);
+    params.x_max = static_cast<double>(center_x + span_x / 2);
+    params.y_min = static_cast<double>(center_y - span_y / 2);
+    params.y_max = static_cast<double>(center_y + span_y / 2);
+    params.pixel_size = span_x / params.width;
+    
+    params.center_x_hi = static_cast<double>(center_x);
+    params.center_x_lo = static_cast<double>(center_x - params.center_x_hi);
+    params.center_y_hi = static_cast<double>(center_y);
+    params.center_y_lo = static_cast<double>(center_y - params.center_y_hi);
+}
+
+// Ler uma coordenada em alta precisão exigindo que o texto inteiro seja consumido
+HighPrecision parse_high_precision(const std::string& option, const char* text) {
+    char* end = nullptr;
+    errno = 0;
+    const HighPrecision value = strtoflt128(text, &end);
+    if (end == text || *end != '\0') {
+        throw std::invalid_argument("Valor inválido para " + option + ": '" + text + "'");
+    }
+    if (errno == ERANGE) {
+        throw std::out_of_range("Valor fora do intervalo para " + option + ": '" + text + "'");
+    }
+    return value;
+}
+
+bool parse_tile_shape(const std::string& name, TileShape& shape) {
+    if (name == "rows") shape = TileShape::ROWS;
+    else if (name == "tiles") shape = TileShape::TILES_2D;
+    else if (name == "interleaved") shape = TileShape::INTERLEAVED;
+    else return false;
+    return true;
+}
+
+// Ler argumentos; devolve false em caso de erro (inclusive números inválidos)
+bool parse_options(int argc, char* argv[], Options& options) {
+    std::vector<std::string> positional;
+    
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto need = [&](int count) {
+                if (i + count >= argc) {
+                    std::cerr << "Faltam valores para " << arg << std::endl;
+                    return false;
+                }
+                return true;
+            };
+        
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                std::exit(0);
+            } else if (arg == "--center") {
+                if (!need(2)) return false;
+                options.center_x = parse_high_precision(arg, argv[++i]);
+                options.center_y = parse_high_precision(arg, argv[++i]);
+            } else if (arg == "--zoom") {
+                if (!need(1)) return false;
+                options.zoom = parse_number<double>(arg, argv[++i]);
+            } else if (arg == "--threads") {
+                if (!need(1)) return false;
+                options.num_threads = parse_number<int>(arg, argv[++i]);
+            } else if (arg == "--kernel") {
+                if (!need(1)) return false;
+                options.kernel = argv[++i];
+            } else if (arg == "--tiles") {
+                if (!need(1)) return false;
+                if (!parse_tile_shape(argv[++i], options.shape)) {
+                    std::cerr << "Formato de tile desconhecido: " << argv[i] << std::endl;
+                    return false;
+                }
+            } else if (arg == "--render") {
+                options.render = true;
+            } else if (arg == "--frames") {
+                if (!need(1)) return false;
+                options.frames = parse_number<int>(arg, argv[++i]);
+            } else if (arg == "--zoom-step") {
+                if (!need(1)) return false;
+                options.zoom_step = parse_number<double>(arg, argv[++i]);
+            } else if (arg == "--output") {
+                if (!need(1)) return false;
+                options.output = argv[++i];
+            } else if (arg == "--cache-mb") {
+                if (!need(1)) return false;
+                options.cache_budget_mb = parse_number<size_t>(arg, argv[++i]);
+            } else if (arg == "--serve") {
+                if (!need(1)) return false;
+                options.serve_path = argv[++i];
+            } else if (arg == "--load-test") {
+                if (!need(1)) return false;
+                options.load_test_path = argv[++i];
+            } else if (parse_harness_option(argc, argv, i)) {
+                continue;
+            } else if (arg == "--clients") {
+                if (!need(1)) return false;
+                options.load_clients = parse_number<int>(arg, argv[++i]);
+            } else if (!arg.empty() && arg[0] == '-' && !std::isdigit(static_cast<unsigned char>(arg[1]))) {
+                std::cerr << "Opção desconhecida: " << arg << std::endl;
+                return false;
+            } else {
+                positional.push_back(arg);
+            }
+        }
+    
+        if (positional.size() != 0 && positional.size() != 3) {
+            std::cerr << "Esperado: largura altura iterações" << std::endl;
+            return false;
+        }
+        if (positional.size() == 3) {
+            options.params.width = parse_number<int>("largura", positional[0].c_str());
+            options.params.height = parse_number<int>("altura", positional[1].c_str());
+            options.params.max_iterations = parse_number<int>("iterações", positional[2].c_str());
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    } catch (const std::out_of_range& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    
+    if (options.params.width <= 0 || options.params.height <= 0 ||
+        options.params.max_iterations <= 0 || options.num_threads <= 0 || options.zoom <= 0.0 ||
+        options.load_clients <= 0) {
+        std::cerr << "Parâmetros devem ser positivos" << std::endl;
+        return false;
+    }
+    
+    set_view(options.params, options.center_x, options.center_y, options.zoom);
+    return true;
+}
+
+// Versão com recarga de lanes sem coleta de estatísticas (para seleção por nome)
+void mandelbrot_simd_refill_tile(std::vector<int>& iterations, const RenderParams& params,
+                                 const Tile& tile) {
+    LaneStats stats;
+    mandelbrot_simd_refill_tile(iterations, params, tile, stats);
+}
+
+// Kernels de tile selecionáveis pela linha de comando
+using TileKernel = void (*)(std::vector<int>&, const RenderParams&, const Tile&);
+
+TileKernel find_tile_kernel(const std::string& name) {
+    if (name == "serial") return mandelbrot_serial_tile;
+    if (name == "simd") return mandelbrot_simd_tile;
+    if (name == "earlyout") return mandelbrot_simd_earlyout_tile;
+    if (name == "float") return mandelbrot_simd_float_tile;
+    if (name == "auto") return mandelbrot_auto_tile;
+    if (name == "refill") return mandelbrot_simd_refill_tile;
+    if (name == "dd") return mandelbrot_dd_tile;
+    return nullptr;
+}
+
+// Renderizar um quadro com o kernel escolhido
+void render_frame(std::vector<int>& iterations, const RenderParams& params, const Options& options) {
+    if (options.kernel == "perturbation") {
+        ReferenceOrbit orbit = compute_reference_orbit(options.center_x, options.center_y,
+                                                       params.max_iterations);
+        PerturbationStats stats;
+        process_tiled(iterations, params, [&](std::vector<int>& iters, const RenderParams& p,
+                                              const Tile& tile) {
+            mandelbrot_perturbation_tile(iters, p, tile, orbit, stats);
+        }, options.num_threads, options.shape);
+        return;
+    }
+    if (options.kernel == "subdivide") {
+        SchedulerStats stats;
+        mandelbrot_subdivide(iterations, params, options.num_threads, stats);
+        return;
+    }
+    process_tiled(iterations, params, find_tile_kernel(options.kernel), options.num_threads,
+                  options.shape);
+}
+
+// Tamanho do pixel no nível 0 do cache de tiles: um tile cobre a vista com zoom 1.
+// No nível L o pixel mede CACHE_BASE_PIXEL_SIZE / 2^L.
+const double CACHE_BASE_PIXEL_SIZE = BASE_VIEW_WIDTH / CACHE_TILE_SIZE;
+
+double cache_pixel_size(int level) {
+    return std::ldexp(CACHE_BASE_PIXEL_SIZE, -level);
+}
+
+// Identificação de um tile do cache: nível, posição na grade global do nível e iterações
+struct TileKey {
+    int level;
+    int64_t tx, ty;
+    int max_iterations;
+    
+    bool operator==(const TileKey& other) const {
+        return level == other.level && tx == other.tx && ty == other.ty &&
+               max_iterations == other.max_iterations;
+    }
+};
+
+struct TileKeyHash {
+    size_t operator()(const TileKey& key) const {
+        size_t h = std::hash<int64_t>()(key.tx);
+        h = h * 31 + std::hash<int64_t>()(key.ty);
+        h = h * 31 + std::hash<int>()(key.level);
+        h = h * 31 + std::hash<int>()(key.max_iterations);
+        return h;
+    }
+};
+
+// Cache LRU de tiles de iterações limitado por memória.
+// Não é thread-safe: consultas e inserções ficam na thread que monta o quadro.
+class TileCache {
+public:
+    explicit TileCache(size_t budget_bytes) : budget_(budget_bytes) {}
+    
+    // Devolve o tile e o marca como o mais recente, ou nullptr se ausente
+    const std::vector<int>* find(const TileKey& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            misses_++;
+            return nullptr;
+        }
+        hits_++;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+    
+    // Inserir um tile, descartando os menos usados até caber no orçamento
+    void insert(const TileKey& key, std::vector<int> tile) {
+        const size_t bytes = tile.size() * sizeof(int);
+        if (bytes > budget_) return;
+        
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            used_ -= it->second->second.size() * sizeof(int);
+            entries_.erase(it->second);
+            index_.erase(it);
+        }
+        
+        while (used_ + bytes > budget_) {
+            const Entry& oldest = entries_.back();
+            used_ -= oldest.second.size() * sizeof(int);
+            index_.erase(oldest.first);
+            entries_.pop_back();
+            evictions_++;
+        }
+        
+        entries_.emplace_front(key, std::move(tile));
+        index_[key] = entries_.begin();
+        used_ += bytes;
+    }
+    
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    uint64_t evictions() const { return evictions_; }
+    size_t used_bytes() const { return used_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    using Entry = std::pair<TileKey, std::vector<int>>;
+    
+    size_t budget_;
+    size_t used_ = 0;
+    std::list<Entry> entries_;  // Mais recente no início
+    std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> index_;
+    uint64_t hits_ = 0, misses_ = 0, evictions_ = 0;
 };
 
-// Versão serial básica
-void mandelbrot_serial(std::vector<int>& iterations, int start_y, int end_y) {
-    double x_scale = (X_MAX - X_MIN) / WIDTH;
-    double y_scale = (Y_MAX - Y_MIN) / HEIGHT;
+// Vista alinhada à grade do cache: nível e pixel global do canto superior esquerdo
+struct CachedView {
+    int level;
+    int64_t gx0, gy0;
+};
 
-    for (int y = start_y; y < end_y; y++) {
-        for (int x = 0; x < WIDTH; x++) {
-            double zx = 0.0, zy = 0.0;
-            double cx = X_MIN + x * x_scale;
-            double cy = Y_MIN + y * y_scale;
-            
-            int iter = 0;
-            while (zx * zx + zy * zy < 4.0 && iter < MAX_ITERATIONS) {
-                double temp = zx * zx - zy * zy + cx;
-                zy = 2.0 * zx * zy + cy;
-                zx = temp;
-                iter++;
+// Escolher o nível mais próximo do zoom pedido e alinhar o canto da vista aos pixels do nível
+CachedView snap_view(const RenderParams& params, double center_x, double center_y, double zoom) {
+    double pixel_size = BASE_VIEW_WIDTH / zoom / params.width;
+    int level = std::max(0, static_cast<int>(std::lround(std::log2(CACHE_BASE_PIXEL_SIZE / pixel_size))));
+    double snapped = cache_pixel_size(level);
+    
+    CachedView view;
+    view.level = level;
+    view.gx0 = std::llround(center_x / snapped) - params.width / 2;
+    view.gy0 = std::llround(center_y / snapped) - params.height / 2;
+    return view;
+}
+
+// Parâmetros de uma região de width x height pixels a partir do pixel global (gx0, gy0)
+RenderParams grid_params(const RenderParams& base, int level, int64_t gx0, int64_t gy0,
+                         int width, int height) {
+    RenderParams params = base;
+    params.width = width;
+    params.height = height;
+    
+    double pixel_size = cache_pixel_size(level);
+    HighPrecision center_x = (static_cast<HighPrecision>(gx0) + width / 2.0) * pixel_size;
+    HighPrecision center_y = (static_cast<HighPrecision>(gy0) + height / 2.0) * pixel_size;
+    set_view(params, center_x, center_y, BASE_VIEW_WIDTH / (pixel_size * width));
+    return params;
+}
+
+int64_t floor_div(int64_t a, int64_t b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+// Copiar a parte de um tile do cache que cai dentro do quadro
+void copy_cached_tile(std::vector<int>& iterations, const RenderParams& params, const CachedView& view,
+                      const TileKey& key, const std::vector<int>& tile) {
+    const int64_t tile_x = key.tx * CACHE_TILE_SIZE - view.gx0;
+    const int64_t tile_y = key.ty * CACHE_TILE_SIZE - view.gy0;
+    const int x0 = static_cast<int>(std::max<int64_t>(0, tile_x));
+    const int x1 = static_cast<int>(std::min<int64_t>(params.width, tile_x + CACHE_TILE_SIZE));
+    const int y0 = static_cast<int>(std::max<int64_t>(0, tile_y));
+    const int y1 = static_cast<int>(std::min<int64_t>(params.height, tile_y + CACHE_TILE_SIZE));
+    
+    for (int y = y0; y < y1; y++) {
+        const int* src = &tile[(y - tile_y) * CACHE_TILE_SIZE + (x0 - tile_x)];
+        std::copy(src, src + (x1 - x0), &iterations[y * params.width + x0]);
+    }
+}
+
+// Renderizar um quadro reaproveitando o cache: só os tiles ausentes vão para os workers.
+// Devolve o número de tiles calculados.
+int render_frame_cached(std::vector<int>& iterations, const RenderParams& params, const CachedView& view,
+                        TileKernel kernel, TileCache& cache, int num_threads) {
+    const int64_t tx0 = floor_div(view.gx0, CACHE_TILE_SIZE);
+    const int64_t tx1 = floor_div(view.gx0 + params.width - 1, CACHE_TILE_SIZE);
+    const int64_t ty0 = floor_div(view.gy0, CACHE_TILE_SIZE);
+    const int64_t ty1 = floor_div(view.gy0 + params.height - 1, CACHE_TILE_SIZE);
+    
+    std::vector<TileKey> missing;
+    for (int64_t ty = ty0; ty <= ty1; ty++) {
+        for (int64_t tx = tx0; tx <= tx1; tx++) {
+            TileKey key{view.level, tx, ty, params.max_iterations};
+            if (const std::vector<int>* tile = cache.find(key)) {
+                copy_cached_tile(iterations, params, view, key, *tile);
+            } else {
+                missing.push_back(key);
             }
-            
-            iterations[y * WIDTH + x] = iter;
         }
     }
+    
+    std::vector<std::vector<int>> rendered(missing.size());
+    if (!missing.empty()) {
+        WorkStealingScheduler<int> scheduler(num_threads);
+        for (size_t i = 0; i < missing.size(); i++) {
+            scheduler.push(i % num_threads, static_cast<int>(i));
+        }
+        scheduler.run([&](int i, int) {
+            const TileKey& key = missing[i];
+            RenderParams tile_params = grid_params(params, key.level, key.tx * CACHE_TILE_SIZE,
+                                                   key.ty * CACHE_TILE_SIZE, CACHE_TILE_SIZE,
+                                                   CACHE_TILE_SIZE);
+            rendered[i].resize(CACHE_TILE_SIZE * CACHE_TILE_SIZE);
+            kernel(rendered[i], tile_params, Tile{0, CACHE_TILE_SIZE, 0, CACHE_TILE_SIZE, 1});
+        });
+    }
+    
+    for (size_t i = 0; i < missing.size(); i++) {
+        copy_cached_tile(iterations, params, view, missing[i], rendered[i]);
+        cache.insert(missing[i], std::move(rendered[i]));
+    }
+    
+    return static_cast<int>(missing.size());
 }
 
-// Versão com AVX2 (SIMD)
-void mandelbrot_simd(std::vector<int>& iterations, int start_y, int end_y) {
-    double x_scale = (X_MAX - X_MIN) / WIDTH;
-    double y_scale = (Y_MAX - Y_MIN) / HEIGHT;
+// Fila limitada entre os estágios do pipeline: push bloqueia quando cheia
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+    
+    void push(const T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&]() { return items_.size() < capacity_; });
+        items_.push_back(item);
+        not_empty_.notify_one();
+    }
+    
+    T pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&]() { return !items_.empty(); });
+        T item = items_.front();
+        items_.pop_front();
+        not_full_.notify_one();
+        return item;
+    }
+
+private:
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+};
+
+// Quadro calculado aguardando colorização e escrita (index < 0 encerra o pipeline)
+struct FrameJob {
+    int index;
+    int buffer;
+    RenderParams params;
+};
 
-    for (int y = start_y; y < end_y; y++) {
-        double cy = Y_MIN + y * y_scale;
+// Sequência de zoom em pipeline: enquanto os workers calculam o quadro k+1,
+// uma thread de escrita colore, codifica e grava o quadro k
+void run_zoom_sequence(const Options& options) {
+    const RenderParams& base = options.params;
+    const size_t pixels = static_cast<size_t>(base.width) * base.height;
+    const std::vector<unsigned char> palette = build_palette(base.max_iterations);
+    
+    std::vector<std::vector<int>> buffers(PIPELINE_DEPTH, std::vector<int>(pixels));
+    BoundedQueue<int> free_buffers(PIPELINE_DEPTH);
+    BoundedQueue<FrameJob> ready_frames(PIPELINE_DEPTH);
+    for (int i = 0; i < PIPELINE_DEPTH; i++) {
+        free_buffers.push(i);
+    }
+    
+    std::cout << "Sequência de zoom: " << options.frames << " quadros "
+              << base.width << "x" << base.height << ", " << base.max_iterations
+              << " iterações, kernel " << options.kernel << ", "
+              << options.num_threads << " threads" << std::endl;
+    
+    double write_time = 0.0;
+    std::thread writer([&]() {
+        std::vector<unsigned char> rgb(3 * pixels);
         
-        for (int x = 0; x < WIDTH; x += 4) {
-            if (x + 3 >= WIDTH) continue; // Evitar acesso fora dos limites
+        while (true) {
+            FrameJob job = ready_frames.pop();
+            if (job.index < 0) break;
             
-            // Preparar 4 pontos em paralelo
-            __m256d zx = _mm256_setzero_pd();
-            __m256d zy = _mm256_setzero_pd();
-            
-            double cx_vals[4] = {
-                X_MIN + (x) * x_scale,
-                X_MIN + (x+1) * x_scale,
-                X_MIN + (x+2) * x_scale,
-                X_MIN + (x+3) * x_scale
-            };
-            __m256d cx = _mm256_loadu_pd(cx_vals);
-            __m256d const_cy = _mm256_set1_pd(cy);
+            write_time += measure_time([&]() {
+                colorize_tile(buffers[job.buffer], rgb, palette, job.params,
+                              Tile{0, job.params.width, 0, job.params.height, 1});
+                char filename[512];
+                std::snprintf(filename, sizeof(filename), "%s_%05d.ppm",
+                              options.output.c_str(), job.index);
+                save_ppm(rgb, job.params, filename);
+            });
+            free_buffers.push(job.buffer);
+        }
+    });
+    
+    double compute_time = 0.0;
+    double total_time = measure_time([&]() {
+        double zoom = options.zoom;
+        for (int k = 0; k < options.frames; k++) {
+            RenderParams params = base;
+            set_view(params, options.center_x, options.center_y, zoom);
             
-            __m256i iters = _mm256_setzero_si256();
-            __m256i ones = _mm256_set1_epi64x(1);
-            __m256i max_iters = _mm256_set1_epi64x(MAX_ITERATIONS);
+            int buffer = free_buffers.pop();
+            compute_time += measure_time([&]() {
+                render_frame(buffers[buffer], params, options);
+            });
+            ready_frames.push(FrameJob{k, buffer, params});
             
-            for (int i = 0; i < MAX_ITERATIONS; i++) {
-                // Calcular zx^2 e zy^2
-                __m256d zx2 = _mm256_mul_pd(zx, zx);
-                __m256d zy2 = _mm256_mul_pd(zy, zy);
-                
-                // Verificar condição de escape
-                __m256d mag2 = _mm256_add_pd(zx2, zy2);
-                __m256d escape_mask = _mm256_cmp_pd(mag2, _mm256_set1_pd(4.0), _CMP_LT_OQ);
-                
-                // Se todos escaparam, sair
-                if (_mm256_movemask_pd(escape_mask) == 0) break;
-                
-                // Atualizar contadores de iteração
-                __m256i mask = _mm256_castpd_si256(escape_mask);
-                iters = _mm256_add_epi64(iters, _mm256_and_si256(mask, ones));
-                
-                // Calcular novo z
-                __m256d new_zx = _mm256_add_pd(_mm256_sub_pd(zx2, zy2), cx);
-                __m256d new_zy = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), 
-                                           _mm256_mul_pd(zx, zy)), const_cy);
-                
-                zx = new_zx;
-                zy = new_zy;
+            zoom *= options.zoom_step;
+        }
+        ready_frames.push(FrameJob{-1, -1, base});
+        writer.join();
+    });
+    
+    std::cout << "Tempo total: " << total_time << "s (" << options.frames / total_time
+              << " quadros/s)" << std::endl;
+    std::cout << "Tempo de cálculo: " << compute_time << "s" << std::endl;
+    std::cout << "Tempo de colorização + I/O: " << write_time << "s" << std::endl;
+    std::cout << "Tempo sem sobreposição (estimado): " << compute_time + write_time
+              << "s, ganho do pipeline: " << (compute_time + write_time) / total_time << "x" << std::endl;
+    std::cout << "Quadros salvos como " << options.output << "_NNNNN.ppm" << std::endl;
+}
+
+// Renderizar uma única imagem com o kernel escolhido
+void run_single_render(const Options& options) {
+    const RenderParams& params = options.params;
+    std::vector<int> iterations(static_cast<size_t>(params.width) * params.height);
+    std::vector<unsigned char> rgb(3 * iterations.size());
+    
+    double compute_time = measure_time([&]() {
+        render_frame(iterations, params, options);
+    });
+    std::cout << "Tempo de cálculo (" << options.kernel << "): " << compute_time << "s" << std::endl;
+    
+    double colorize_time = measure_time([&]() {
+        colorize_parallel(iterations, rgb, build_palette(params.max_iterations), params,
+                          options.num_threads);
+    });
+    std::string filename = options.output + ".ppm";
+    double io_time = measure_time([&]() {
+        save_ppm(rgb, params, filename);
+    });
+    std::cout << "Tempo de colorização: " << colorize_time << "s" << std::endl;
+    std::cout << "Tempo de I/O: " << io_time << "s" << std::endl;
+    std::cout << "Imagem salva como " << filename << std::endl;
+}
+
+// Protocolo binário do servidor de tiles (socket Unix, ordem de bytes nativa).
+// O cliente envia um lote: TileBatchHeader seguido de count TileRequestMessage.
+// O servidor responde na mesma ordem: TileResponseHeader e, se status == 0,
+// CACHE_TILE_SIZE * CACHE_TILE_SIZE contadores int32 em ordem de linhas.
+struct TileBatchHeader {
+    int32_t count;
+};
+
+struct TileRequestMessage {
+    int32_t level;
+    int32_t max_iterations;
+    int64_t tx, ty;
+    int32_t prefetch;  // 0 = tile visível, 1 = pré-carregamento
+    int32_t reserved;
+};
+
+struct TileResponseHeader {
+    int32_t status;  // 0 = ok, 1 = pedido inválido, 2 = servidor encerrando
+    int32_t size;
+};
+
+// Limites aceitos pelo servidor
+const int SERVER_MAX_BATCH = 4096;
+const int SERVER_MAX_LEVEL = 48;
+const int SERVER_MAX_ITERATIONS = 1 << 20;
+
+// No nível L um tile mede BASE_VIEW_WIDTH / 2^L e o conjunto fica em |c| <= 2, então
+// |tx|, |ty| < 2^L já cobrem tudo. A folga de 2^SERVER_TILE_MARGIN_BITS deixa passar pans
+// longos como os do gerador de carga, e tx * CACHE_TILE_SIZE fica abaixo de 2^62 no
+// nível máximo (sem estouro de int64_t)
+const int SERVER_TILE_MARGIN_BITS = 8;
+
+bool read_full(int fd, void* buffer, size_t size) {
+    char* data = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t n = read(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool write_full(int fd, const void* buffer, size_t size) {
+    const char* data = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Tile pedido por um ou mais clientes e ainda não entregue
+struct PendingTile {
+    bool visible;
+    bool started = false;
+    bool done = false;
+    std::vector<int> data;
+};
+
+// Contadores do servidor
+struct TileServerStats {
+    uint64_t requests = 0;
+    uint64_t cache_hits = 0;
+    uint64_t merged = 0;     // Pedidos atendidos por um cálculo já pendente
+    uint64_t computed = 0;
+    uint64_t promoted = 0;   // Pré-carregamentos promovidos a visíveis
+};
+
+// Núcleo do servidor de tiles: workers permanentes consomem os tiles pendentes,
+// sempre os visíveis antes dos pré-carregamentos. Pedidos simultâneos do mesmo
+// tile são combinados num único cálculo, e tiles prontos ficam no cache LRU.
+class TileServer {
+public:
+    TileServer(const RenderParams& base, TileKernel kernel, int num_threads, size_t cache_budget)
+        : base_(base), kernel_(kernel), cache_(cache_budget) {
+        for (int i = 0; i < num_threads; i++) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+    
+    ~TileServer() {
+        stop();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+    
+    // Registrar o pedido de um tile; o resultado fica disponível via wait()
+    std::shared_ptr<PendingTile> submit(const TileKey& key, bool visible) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.requests++;
+        
+        if (const std::vector<int>* tile = cache_.find(key)) {
+            stats_.cache_hits++;
+            auto ready = std::make_shared<PendingTile>();
+            ready->visible = visible;
+            ready->done = true;
+            ready->data = *tile;
+            return ready;
+        }
+        
+        auto it = pending_.find(key);
+        if (it != pending_.end()) {
+            stats_.merged++;
+            std::shared_ptr<PendingTile> pending = it->second;
+            if (visible && !pending->visible && !pending->started) {
+                // A entrada antiga na fila de pré-carregamento será ignorada
+                pending->visible = true;
+                visible_queue_.push_back(key);
+                stats_.promoted++;
+                work_available_.notify_one();
             }
+            return pending;
+        }
+        
+        auto pending = std::make_shared<PendingTile>();
+        pending->visible = visible;
+        pending_[key] = pending;
+        (visible ? visible_queue_ : prefetch_queue_).push_back(key);
+        work_available_.notify_one();
+        return pending;
+    }
+    
+    // Esperar o tile ficar pronto; devolve false se o servidor estiver encerrando
+    bool wait(const std::shared_ptr<PendingTile>& tile) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        tile_ready_.wait(lock, [&]() { return tile->done || stopping_; });
+        return tile->done;
+    }
+    
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        work_available_.notify_all();
+        tile_ready_.notify_all();
+    }
+    
+    TileServerStats stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+    
+    size_t cached_tiles() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cache_.size();
+    }
+
+private:
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_available_.wait(lock, [&]() {
+                return stopping_ || !visible_queue_.empty() || !prefetch_queue_.empty();
+            });
+            if (stopping_) return;
             
-            // Armazenar resultados
-            int64_t result[4];
-            _mm256_storeu_si256((__m256i*)result, iters);
+            std::deque<TileKey>& queue = visible_queue_.empty() ? prefetch_queue_ : visible_queue_;
+            TileKey key = queue.front();
+            queue.pop_front();
             
-            for (int i = 0; i < 4; i++) {
-                if (x + i < WIDTH) {
-                    iterations[y * WIDTH + x + i] = result[i];
-                }
+            auto it = pending_.find(key);
+            if (it == pending_.end() || it->second->started) continue;
+            std::shared_ptr<PendingTile> pending = it->second;
+            pending->started = true;
+            
+            lock.unlock();
+            std::vector<int> tile(CACHE_TILE_SIZE * CACHE_TILE_SIZE);
+            RenderParams params = grid_params(base_, key.level, key.tx * CACHE_TILE_SIZE,
+                                              key.ty * CACHE_TILE_SIZE, CACHE_TILE_SIZE, CACHE_TILE_SIZE);
+            params.max_iterations = key.max_iterations;
+            kernel_(tile, params, Tile{0, CACHE_TILE_SIZE, 0, CACHE_TILE_SIZE, 1});
+            lock.lock();
+            
+            pending->data = tile;
+            pending->done = true;
+            cache_.insert(key, std::move(tile));
+            pending_.erase(key);
+            stats_.computed++;
+            tile_ready_.notify_all();
+        }
+    }
+    
+    RenderParams base_;
+    TileKernel kernel_;
+    
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable tile_ready_;
+    TileCache cache_;
+    std::unordered_map<TileKey, std::shared_ptr<PendingTile>, TileKeyHash> pending_;
+    std::deque<TileKey> visible_queue_;
+    std::deque<TileKey> prefetch_queue_;
+    TileServerStats stats_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+bool valid_tile_request(const TileRequestMessage& request) {
+    if (request.level < 0 || request.level > SERVER_MAX_LEVEL) return false;
+    const int64_t tile_limit = int64_t(1) << (request.level + SERVER_TILE_MARGIN_BITS);
+    return request.max_iterations > 0 && request.max_iterations <= SERVER_MAX_ITERATIONS &&
+           request.tx >= -tile_limit && request.tx < tile_limit &&
+           request.ty >= -tile_limit && request.ty < tile_limit;
+}
+
+// Atender uma conexão: ler lotes, registrar todos os tiles e responder na ordem pedida
+void serve_connection(int fd, TileServer& server) {
+    std::vector<TileRequestMessage> requests;
+    std::vector<std::shared_ptr<PendingTile>> tiles;
+    
+    while (true) {
+        TileBatchHeader header;
+        if (!read_full(fd, &header, sizeof(header))) break;
+        if (header.count <= 0 || header.count > SERVER_MAX_BATCH) break;
+        
+        requests.resize(header.count);
+        if (!read_full(fd, requests.data(), requests.size() * sizeof(TileRequestMessage))) break;
+        
+        tiles.assign(requests.size(), nullptr);
+        for (size_t i = 0; i < requests.size(); i++) {
+            const TileRequestMessage& request = requests[i];
+            if (valid_tile_request(request)) {
+                tiles[i] = server.submit(TileKey{request.level, request.tx, request.ty, request.max_iterations},
+                                         request.prefetch == 0);
+            }
+        }
+        
+        bool ok = true;
+        for (size_t i = 0; i < tiles.size() && ok; i++) {
+            TileResponseHeader response{0, CACHE_TILE_SIZE};
+            if (!tiles[i]) {
+                response.status = 1;
+            } else if (!server.wait(tiles[i])) {
+                response.status = 2;
+            }
+            ok = write_full(fd, &response, sizeof(response));
+            if (ok && response.status == 0) {
+                ok = write_full(fd, tiles[i]->data.data(), tiles[i]->data.size() * sizeof(int));
             }
         }
+        if (!ok) break;
     }
 }
 
-// Função para processamento multi-thread
-template<typename Func>
-void process_threaded(std::vector<int>& iterations, Func func, int num_threads) {
-    std::vector<std::thread> threads;
-    int rows_per_thread = HEIGHT / num_threads;
+volatile std::sig_atomic_t server_interrupted = 0;
+
+void handle_server_signal(int) {
+    server_interrupted = 1;
+}
+
+// Conectar ao socket Unix do servidor; devolve -1 em caso de erro
+int connect_tile_server(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Servidor de tiles: mantém workers e cache vivos entre pedidos até SIGINT/SIGTERM
+int run_tile_server(const Options& options) {
+    TileKernel kernel = find_tile_kernel(options.kernel);
+    if (kernel == nullptr) {
+        std::cerr << "O servidor precisa de um kernel de tile (não " << options.kernel << ")" << std::endl;
+        return 1;
+    }
+    
+    const std::string& path = options.serve_path;
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (listen_fd < 0 || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Não foi possível criar o socket " << path << std::endl;
+        return 1;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, 128) < 0) {
+        std::cerr << "Não foi possível escutar em " << path << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        return 1;
+    }
+    
+    struct sigaction action{};
+    action.sa_handler = handle_server_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
     
-    for (int i = 0; i < num_threads; i++) {
-        int start_y = i * rows_per_thread;
-        int end_y = (i == num_threads - 1) ? HEIGHT : start_y + rows_per_thread;
+    std::cout << "Servidor de tiles em " << path << ": tiles " << CACHE_TILE_SIZE << "x" << CACHE_TILE_SIZE
+              << ", kernel " << options.kernel << ", " << options.num_threads << " workers, cache de "
+              << options.cache_budget_mb << " MiB" << std::endl;
+    
+    auto server = std::make_unique<TileServer>(options.params, kernel, options.num_threads,
+                                               options.cache_budget_mb * 1024 * 1024);
+    std::mutex connections_mutex;
+    std::condition_variable connections_done;
+    std::vector<int> connections;
+    
+    while (!server_interrupted) {
+        // Acordar periodicamente para verificar o sinal de encerramento
+        pollfd listen_poll{listen_fd, POLLIN, 0};
+        if (poll(&listen_poll, 1, 200) <= 0) continue;
         
-        threads.emplace_back([&, start_y, end_y]() {
-            func(iterations, start_y, end_y);
-        });
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) continue;
+        
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        connections.push_back(fd);
+        std::thread([&, fd]() {
+            serve_connection(fd, *server);
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            close(fd);
+            connections.erase(std::find(connections.begin(), connections.end(), fd));
+            connections_done.notify_all();
+        }).detach();
     }
     
-    for (auto& thread : threads) {
-        thread.join();
+    // Encerrar: acordar quem espera tiles, derrubar as conexões e esperar as threads
+    close(listen_fd);
+    unlink(path.c_str());
+    server->stop();
+    {
+        std::unique_lock<std::mutex> lock(connections_mutex);
+        for (int fd : connections) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        connections_done.wait(lock, [&]() { return connections.empty(); });
     }
+    
+    TileServerStats stats = server->stats();
+    std::cout << "\nPedidos: " << stats.requests << ", acertos no cache: " << stats.cache_hits
+              << ", combinados com cálculo pendente: " << stats.merged
+              << ", calculados: " << stats.computed << ", pré-carregamentos promovidos: "
+              << stats.promoted << std::endl;
+    std::cout << "Tiles em cache: " << server->cached_tiles() << std::endl;
+    server.reset();
+    return 0;
+}
+
+// Visão de um cliente do gerador de carga, em tiles
+const int LOAD_VIEW_TILES_X = 4;
+const int LOAD_VIEW_TILES_Y = 3;
+const int LOAD_FRAMES_PER_CLIENT = 24;
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[index];
 }
 
-// Gerar imagem PPM
-void save_ppm(const std::vector<int>& iterations, const std::string& filename) {
-    std::ofstream file(filename);
-    file << "P3\n" << WIDTH << " " << HEIGHT << "\n255\n";
+// Gerador de carga: cada cliente percorre a vista em pans de um tile para a direita,
+// pedindo os tiles visíveis e a próxima coluna como pré-carregamento. Clientes vizinhos
+// se sobrepõem em duas de três linhas. Cada rodada usa outro max_iterations para não
+// reaproveitar o cache da rodada anterior.
+int run_load_test(const Options& options) {
+    const RenderParams& params = options.params;
+    CachedView view = snap_view(params, static_cast<double>(options.center_x),
+                                static_cast<double>(options.center_y), options.zoom);
+    const int64_t tx0 = floor_div(view.gx0, CACHE_TILE_SIZE);
+    const int64_t ty0 = floor_div(view.gy0, CACHE_TILE_SIZE);
+    const size_t tile_bytes = CACHE_TILE_SIZE * CACHE_TILE_SIZE * sizeof(int);
     
-    for (int y = 0; y < HEIGHT; y++) {
-        for (int x = 0; x < WIDTH; x++) {
-            int iter = iterations[y * WIDTH + x];
-            
-            // Mapear iterações para cores
-            unsigned char r, g, b;
-            if (iter == MAX_ITERATIONS) {
-                r = g = b = 0; // Preto para pontos no conjunto
-            } else {
-                // Esquema de cores simples
-                r = static_cast<unsigned char>((iter * 5) % 256);
-                g = static_cast<unsigned char>((iter * 7) % 256);
-                b = static_cast<unsigned char>((iter * 11) % 256);
+    std::cout << "Gerador de carga em " << options.load_test_path << ": nível " << view.level
+              << ", vista de " << LOAD_VIEW_TILES_X << "x" << LOAD_VIEW_TILES_Y << " tiles, "
+              << LOAD_FRAMES_PER_CLIENT << " quadros por cliente" << std::endl;
+    
+    int round = 0;
+    for (int clients = 1; clients <= options.load_clients; clients *= 2, round++) {
+        const int max_iterations = params.max_iterations + round;
+        std::vector<std::vector<double>> visible_latency(clients), prefetch_latency(clients);
+        std::atomic<uint64_t> tiles_received{0};
+        std::atomic<bool> failed{false};
+        
+        double wall_time = measure_time([&]() {
+            std::vector<std::thread> threads;
+            for (int c = 0; c < clients; c++) {
+                threads.emplace_back([&, c]() {
+                    int fd = connect_tile_server(options.load_test_path);
+                    if (fd < 0) {
+                        failed = true;
+                        return;
+                    }
+                    
+                    std::vector<TileRequestMessage> batch;
+                    std::vector<int> tile(CACHE_TILE_SIZE * CACHE_TILE_SIZE);
+                    for (int frame = 0; frame < LOAD_FRAMES_PER_CLIENT && !failed; frame++) {
+                        const int64_t left = tx0 + frame;
+                        const int64_t top = ty0 + c;
+                        batch.clear();
+                        for (int y = 0; y < LOAD_VIEW_TILES_Y; y++) {
+                            for (int x = 0; x < LOAD_VIEW_TILES_X; x++) {
+                                batch.push_back({view.level, max_iterations, left + x, top + y, 0, 0});
+                            }
+                        }
+                        for (int y = 0; y < LOAD_VIEW_TILES_Y; y++) {
+                            batch.push_back({view.level, max_iterations, left + LOAD_VIEW_TILES_X, top + y, 1, 0});
+                        }
+                        
+                        auto start = std::chrono::high_resolution_clock::now();
+                        TileBatchHeader header{static_cast<int32_t>(batch.size())};
+                        if (!write_full(fd, &header, sizeof(header)) ||
+                            !write_full(fd, batch.data(), batch.size() * sizeof(TileRequestMessage))) {
+                            failed = true;
+                            break;
+                        }
+                        for (const TileRequestMessage& request : batch) {
+                            TileResponseHeader response;
+                            if (!read_full(fd, &response, sizeof(response)) || response.status != 0 ||
+                                !read_full(fd, tile.data(), tile_bytes)) {
+                                failed = true;
+                                break;
+                            }
+                            auto end = std::chrono::high_resolution_clock::now();
+                            double latency = std::chrono::duration<double>(end - start).count();
+                            (request.prefetch ? prefetch_latency[c] : visible_latency[c]).push_back(latency);
+                            tiles_received++;
+                        }
+                    }
+                    close(fd);
+                });
             }
-            
-            file << static_cast<int>(r) << " " 
-                 << static_cast<int>(g) << " " 
-                 << static_cast<int>(b) << " ";
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        });
+        
+        if (failed) {
+            std::cerr << "Falha na comunicação com o servidor em " << options.load_test_path << std::endl;
+            return 1;
+        }
+        
+        std::vector<double> visible, prefetch;
+        for (int c = 0; c < clients; c++) {
+            visible.insert(visible.end(), visible_latency[c].begin(), visible_latency[c].end());
+            prefetch.insert(prefetch.end(), prefetch_latency[c].begin(), prefetch_latency[c].end());
         }
-        file << "\n";
+        std::cout << clients << " cliente(s): " << tiles_received / wall_time << " tiles/s, visíveis p50 "
+                  << percentile(visible, 0.50) * 1e3 << " ms, p99 " << percentile(visible, 0.99) * 1e3
+                  << " ms; pré-carregamento p50 " << percentile(prefetch, 0.50) * 1e3 << " ms, p99 "
+                  << percentile(prefetch, 0.99) * 1e3 << " ms" << std::endl;
     }
+    return 0;
 }
 
-// Medir tempo de execução
-template<typename Func>
-double measure_time(Func func) {
-    auto start = std::chrono::high_resolution_clock::now();
-    func();
-    auto end = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration<double>(end - start).count();
+// Passo do percurso de pan/zoom: deslocamento em frações da vista e fator de zoom
+struct PanZoomStep {
+    const char* name;
+    double dx, dy;
+    double zoom_factor;
+};
+
+// Percurso roteirizado: pans curtos, zoom in, zoom out e volta sobre regiões já vistas
+std::vector<PanZoomStep> scripted_pan_zoom_path() {
+    std::vector<PanZoomStep> path = {{"início", 0.0, 0.0, 1.0}};
+    for (int i = 0; i < 6; i++) path.push_back({"pan direita", 0.125, 0.0, 1.0});
+    path.push_back({"zoom in", 0.0, 0.0, 2.0});
+    for (int i = 0; i < 4; i++) path.push_back({"pan baixo", 0.0, 0.125, 1.0});
+    path.push_back({"zoom out", 0.0, 0.0, 0.5});
+    for (int i = 0; i < 6; i++) path.push_back({"pan esquerda", -0.125, 0.0, 1.0});
+    path.push_back({"zoom in", 0.0, 0.0, 2.0});
+    return path;
 }
 
-// Função principal
-int main() {
-    std::vector<int> iterations_serial(WIDTH * HEIGHT);
-    std::vector<int> iterations_simd(WIDTH * HEIGHT);
-    std::vector<int> iterations_threaded(WIDTH * HEIGHT);
-    std::vector<int> iterations_simd_threaded(WIDTH * HEIGHT);
+// Reproduzir o percurso com e sem cache e exibir a latência de cada quadro
+void run_pan_zoom_replay(const Options& options) {
+    const RenderParams& base = options.params;
+    const TileKernel kernel = mandelbrot_simd_tile;
+    std::vector<int> iterations_full(static_cast<size_t>(base.width) * base.height);
+    std::vector<int> iterations_cached(iterations_full.size());
+    TileCache cache(options.cache_budget_mb * 1024 * 1024);
+    
+    double center_x = static_cast<double>(options.center_x);
+    double center_y = static_cast<double>(options.center_y);
+    double zoom = options.zoom;
+    double total_full = 0.0, total_cached = 0.0;
+    size_t mismatches = 0;
+    
+    const std::vector<PanZoomStep> path = scripted_pan_zoom_path();
+    for (size_t k = 0; k < path.size(); k++) {
+        const PanZoomStep& step = path[k];
+        double view_width = BASE_VIEW_WIDTH / zoom;
+        center_x += step.dx * view_width;
+        center_y += step.dy * view_width;
+        zoom *= step.zoom_factor;
+        
+        // As duas versões calculam a mesma vista alinhada à grade do cache
+        CachedView view = snap_view(base, center_x, center_y, zoom);
+        RenderParams params = grid_params(base, view.level, view.gx0, view.gy0, base.width, base.height);
+        
+        double full_time = measure_time([&]() {
+            process_tiled(iterations_full, params, kernel, options.num_threads, TileShape::TILES_2D);
+        });
+        int computed = 0;
+        double cached_time = measure_time([&]() {
+            computed = render_frame_cached(iterations_cached, params, view, kernel, cache,
+                                           options.num_threads);
+        });
+        total_full += full_time;
+        total_cached += cached_time;
+        mismatches += count_mismatches(iterations_full, iterations_cached);
+        
+        std::cout << "Quadro " << k << " (" << step.name << ", nível " << view.level << "): sem cache "
+                  << full_time * 1e3 << " ms, com cache " << cached_time * 1e3 << " ms, "
+                  << computed << " tiles calculados" << std::endl;
+    }
+    
+    uint64_t lookups = cache.hits() + cache.misses();
+    std::cout << "Total: sem cache " << total_full << "s, com cache " << total_cached << "s (speedup "
+              << total_full / total_cached << "x)" << std::endl;
+    std::cout << "Cache: " << cache.hits() << " acertos, " << cache.misses() << " falhas ("
+              << 100.0 * cache.hits() / lookups << "% de acerto), " << cache.evictions()
+              << " descartes, " << cache.size() << " tiles em "
+              << cache.used_bytes() / (1024.0 * 1024.0) << " MiB (orçamento "
+              << options.cache_budget_mb << " MiB)" << std::endl;
+    std::cout << "Pixels diferentes entre as versões: " << mismatches << std::endl;
+}
+
+// Todas as instanciações de mandelbrot_tile<T, isa, unroll> na imagem inteira, na thread
+// principal e com o escalonador por tiles 2D; cada uma é comparada com a escalar x1 do
+// mesmo tipo, que usa as mesmas operações na mesma ordem. A primeira execução é a
+// verificada; as medições vão para timings como as das versões principais.
+template<typename T>
+void run_kernel_matrix(const Options& options, HarnessCsv& timings, std::ofstream& csv_file) {
+    const RenderParams& params = options.params;
+    const size_t pixels = static_cast<size_t>(params.width) * params.height;
+    const Tile full_image{0, params.width, 0, params.height, 1};
+    
+    std::vector<int> reference(pixels);
+    mandelbrot_tile<T, Isa::SCALAR>(reference, params, full_image);
+    const double work = total_iterations(reference);
+    std::vector<int> result(pixels);
+    HarnessOptions harness = harness_options;
+    harness.min_time = std::min(harness.min_time, MATRIX_MIN_TIME);
+    
+    for_each_kernel_config<T>([&](auto config) {
+        using Config = decltype(config);
+        const auto kernel = mandelbrot_tile<T, Config::isa, Config::unroll>;
+        for (int threads : {0, options.num_threads}) {
+            auto run = [&]() {
+                if (threads == 0) kernel(result, params, full_image);
+                else process_tiled(result, params, kernel, threads, TileShape::TILES_2D);
+            };
+            std::fill(result.begin(), result.end(), -1);
+            run();
+            const size_t mismatches = count_mismatches(reference, result);
+            
+            const std::string name = Config::name() + (threads == 0 ? "" : " pool");
+            const TimingStats stats = measure_stats(timings, "matriz", name, pixels, std::max(1, threads), run, harness);
+            const double seconds = stats.median;
+            
+            std::cout << Config::name() << (threads == 0 ? ", thread principal: " : ", escalonador com ")
+                      << (threads == 0 ? "" : std::to_string(threads) + " thread(s): ") << seconds << "s, "
+                      << work / seconds / 1e6 << " Miterações/s, pixels diferentes: " << mismatches << std::endl;
+            csv_file << type_name<T>() << "," << isa_name(Config::isa) << "," << Config::unroll << ","
+                     << std::max(1, threads) << "," << (threads == 0 ? 0 : 1) << "," << seconds << ","
+                     << work / seconds / 1e6 << "," << mismatches << "\n";
+        }
+    });
+}
+
+// Benchmark comparativo de todas as versões
+void run_benchmark(const Options& options) {
+    const RenderParams& params = options.params;
+    const int num_threads = options.num_threads;
+    const size_t pixels = static_cast<size_t>(params.width) * params.height;
+    
+    std::vector<int> iterations_serial(pixels);
+    std::vector<int> iterations_simd(pixels);
+    std::vector<int> iterations_threaded(pixels);
+    std::vector<int> iterations_simd_threaded(pixels);
     
     TimingData timing;
-    const int num_threads = std::thread::hardware_concurrency();
     
     std::cout << "Iniciando cálculo do Conjunto de Mandelbrot..." << std::endl;
-    std::cout << "Resolução: " << WIDTH << "x" << HEIGHT << std::endl;
-    std::cout << "Máximo de iterações: " << MAX_ITERATIONS << std::endl;
-    std::cout << "Número de threads disponíveis: " << num_threads << std::endl;
+    std::cout << "Resolução: " << params.width << "x" << params.height << std::endl;
+    std::cout << "Máximo de iterações: " << params.max_iterations << std::endl;
+    std::cout << "Número de threads: " << num_threads << std::endl;
+    std::cout << "Medição: " << harness_options.warmup_runs << " aquecimento(s), pelo menos "
+              << harness_options.min_runs << " execuções e " << harness_options.min_time << " s por versão"
+              << std::endl;
+    HarnessCsv timings("mandelbrot_timings.csv", "mandelbrot");  // Medições das versões principais
     
     // Versão serial
     std::cout << "\nExecutando versão serial..." << std::endl;
-    timing.serial_time = measure_time([&]() {
-        mandelbrot_serial(iterations_serial, 0, HEIGHT);
+    PerfRegion serial_region;
+    const TimingStats serial_stats = measure_stats(timings, "benchmark", "Serial", pixels, 1, [&]() {
+        mandelbrot_serial(iterations_serial, params, 0, params.height);
     });
+    timing.serial_time = serial_stats.median;
+    timing.serial_counters = serial_region.stop(serial_stats.calls());
     std::cout << "Tempo serial: " << timing.serial_time << "s" << std::endl;
     
     // Versão SIMD
     std::cout << "\nExecutando versão SIMD (AVX2)..." << std::endl;
-    timing.simd_time = measure_time([&]() {
-        mandelbrot_simd(iterations_simd, 0, HEIGHT);
+    PerfRegion simd_region;
+    const TimingStats simd_stats = measure_stats(timings, "benchmark", "SIMD", pixels, 1, [&]() {
+        mandelbrot_simd(iterations_simd, params, 0, params.height);
     });
+    timing.simd_time = simd_stats.median;
+    timing.simd_counters = simd_region.stop(simd_stats.calls());
     std::cout << "Tempo SIMD: " << timing.simd_time << "s" << std::endl;
     
     // Versão multi-thread
     std::cout << "\nExecutando versão multi-thread (" << num_threads << " threads)..." << std::endl;
-    timing.threaded_time = measure_time([&]() {
-        process_threaded(iterations_threaded, mandelbrot_serial, num_threads);
+    PerfRegion threaded_region(num_threads);
+    const TimingStats threaded_stats = measure_stats(timings, "benchmark", "Multi-thread", pixels, num_threads, [&]() {
+        process_threaded(iterations_threaded, params, mandelbrot_serial, num_threads);
     });
+    timing.threaded_time = threaded_stats.median;
+    timing.threaded_counters = threaded_region.stop(threaded_stats.calls());
     std::cout << "Tempo multi-thread: " << timing.threaded_time << "s" << std::endl;
     
     // Versão SIMD + multi-thread
     std::cout << "\nExecutando versão SIMD + multi-thread..." << std::endl;
-    timing.simd_threaded_time = measure_time([&]() {
-        process_threaded(iterations_simd_threaded, mandelbrot_simd, num_threads);
-    });
+    PerfRegion simd_threaded_region(num_threads);
+    const TimingStats simd_threaded_stats =
+        measure_stats(timings, "benchmark", "SIMD+Multi-thread", pixels, num_threads, [&]() {
+            process_threaded(iterations_simd_threaded, params, mandelbrot_simd, num_threads);
+        });
+    timing.simd_threaded_time = simd_threaded_stats.median;
+    timing.simd_threaded_counters = simd_threaded_region.stop(simd_threaded_stats.calls());
     std::cout << "Tempo SIMD + multi-thread: " << timing.simd_threaded_time << "s" << std::endl;
     
     // Calcular speedups
@@ -224,15 +2531,364 @@ int main() {
     std::cout << "Speedup Multi-thread: " << speedup_threaded << "x" << std::endl;
     std::cout << "Speedup SIMD + Multi-thread: " << speedup_simd_threaded << "x" << std::endl;
     std::cout << "Eficiência paralela: " << (speedup_simd_threaded / num_threads) * 100 << "%" << std::endl;
+    print_timing_stats("Serial", serial_stats);
+    print_timing_stats("SIMD", simd_stats);
+    print_timing_stats("Multi-thread", threaded_stats);
+    print_timing_stats("SIMD+Multi-thread", simd_threaded_stats);
+    
+    // Roofline: as iterações úteis são as mesmas em todas as versões
+    std::cout << "\n=== ROOFLINE ===" << std::endl;
+    print_roofline(machine_roofline(1));
+    if (num_threads != 1) print_roofline(machine_roofline(num_threads));
+    const double serial_iterations = total_iterations(iterations_serial);
+    const double flops = MANDELBROT_FLOPS_PER_ITERATION * serial_iterations;
+    const double bytes = MANDELBROT_BYTES_PER_PIXEL * pixels;
+    const std::vector<std::pair<std::string, RooflinePoint>> roofline_points = {
+        {"Serial", machine_roofline(1).evaluate(flops, bytes, timing.serial_time, true)},
+        {"SIMD", machine_roofline(1).evaluate(flops, bytes, timing.simd_time, true)},
+        {"Multi-thread", machine_roofline(num_threads).evaluate(flops, bytes, timing.threaded_time, true)},
+        {"SIMD+Multi-thread",
+         machine_roofline(num_threads).evaluate(flops, bytes, timing.simd_threaded_time, true)}
+    };
+    const std::vector<double> times = {timing.serial_time, timing.simd_time, timing.threaded_time,
+                                       timing.simd_threaded_time};
+    const std::vector<PerfSample> counters = {timing.serial_counters, timing.simd_counters,
+                                              timing.threaded_counters, timing.simd_threaded_counters};
+    
+    std::ofstream csv_file("mandelbrot_results.csv");
+    csv_file << "Implementação,Tempo(s),Speedup,Iterações" << ROOFLINE_CSV_HEADER << perf_csv_header() << "\n";
+    for (size_t i = 0; i < roofline_points.size(); i++) {
+        print_roofline_point(roofline_points[i].first, roofline_points[i].second);
+        print_perf_sample(roofline_points[i].first, counters[i]);
+        csv_file << roofline_points[i].first << "," << times[i] << "," << timing.serial_time / times[i] << ","
+                 << static_cast<uint64_t>(serial_iterations) << roofline_csv_columns(roofline_points[i].second)
+                 << perf_csv_columns(counters[i]) << "\n";
+    }
+    std::cout << "Resultados salvos em mandelbrot_results.csv" << std::endl;
+    
+    // Custo de despacho: pool persistente vs criar threads a cada chamada
+    std::cout << "\n=== DESPACHO (POOL vs THREADS POR CHAMADA) ===" << std::endl;
+    double pool_dispatch, spawn_dispatch;
+    measure_dispatch_overhead(num_threads, DISPATCH_CALLS, pool_dispatch, spawn_dispatch);
+    std::cout << "Despacho vazio: pool " << pool_dispatch * 1e6 << " us, threads por chamada "
+              << spawn_dispatch * 1e6 << " us" << std::endl;
+    
+    RenderParams small_params = params;
+    small_params.width = DISPATCH_RENDER_SIZE;
+    small_params.height = DISPATCH_RENDER_SIZE;
+    small_params.pixel_size = params.pixel_size * params.width / DISPATCH_RENDER_SIZE;
+    std::vector<int> iterations_small(static_cast<size_t>(DISPATCH_RENDER_SIZE) * DISPATCH_RENDER_SIZE);
+    
+    // Cada amostra cronometra DISPATCH_CALLS renderizações e guarda o tempo por chamada
+    const size_t small_pixels = iterations_small.size();
+    double small_pool_time = measure_stats(timings, "despacho", "Pool", small_pixels, num_threads, [&]() {
+        process_threaded(iterations_small, small_params, mandelbrot_simd, num_threads);
+    }, harness_options, DISPATCH_CALLS).median;
+    double small_spawn_time =
+        measure_stats(timings, "despacho", "Threads por chamada", small_pixels, num_threads, [&]() {
+            process_threaded_spawn(iterations_small, small_params, mandelbrot_simd, num_threads);
+        }, harness_options, DISPATCH_CALLS).median;
+    std::cout << "Render " << DISPATCH_RENDER_SIZE << "x" << DISPATCH_RENDER_SIZE
+              << " SIMD + threads: pool " << small_pool_time * 1e6 << " us, threads por chamada "
+              << small_spawn_time * 1e6 << " us (ganho " << small_spawn_time / small_pool_time << "x)" << std::endl;
+    
+    // Saída antecipada para o interior (cardioide/bulbo + periodicidade)
+    std::cout << "\n=== SAÍDA ANTECIPADA (CARDIOIDE/BULBO + PERIODICIDADE) ===" << std::endl;
+    std::vector<int> iterations_earlyout(pixels);
+    
+    timing.serial_earlyout_time = measure_stats(timings, "early-out", "Serial", pixels, 1, [&]() {
+        mandelbrot_serial_earlyout(iterations_earlyout, params, 0, params.height);
+    }).median;
+    std::cout << "Serial: " << timing.serial_time << "s -> early-out: "
+              << timing.serial_earlyout_time << "s (speedup "
+              << timing.serial_time / timing.serial_earlyout_time << "x, pixels diferentes: "
+              << count_mismatches(iterations_serial, iterations_earlyout) << ")" << std::endl;
+    
+    timing.simd_earlyout_time = measure_stats(timings, "early-out", "SIMD", pixels, 1, [&]() {
+        mandelbrot_simd_earlyout(iterations_earlyout, params, 0, params.height);
+    }).median;
+    std::cout << "SIMD: " << timing.simd_time << "s -> early-out: "
+              << timing.simd_earlyout_time << "s (speedup "
+              << timing.simd_time / timing.simd_earlyout_time << "x, pixels diferentes: "
+              << count_mismatches(iterations_simd, iterations_earlyout) << ")" << std::endl;
+    
+    timing.simd_threaded_earlyout_time =
+        measure_stats(timings, "early-out", "SIMD+Multi-thread", pixels, num_threads, [&]() {
+            process_threaded(iterations_earlyout, params, mandelbrot_simd_earlyout, num_threads);
+        }).median;
+    std::cout << "SIMD + multi-thread: " << timing.simd_threaded_time << "s -> early-out: "
+              << timing.simd_threaded_earlyout_time << "s (speedup "
+              << timing.simd_threaded_time / timing.simd_threaded_earlyout_time << "x, pixels diferentes: "
+              << count_mismatches(iterations_simd_threaded, iterations_earlyout) << ")" << std::endl;
+    
+    // Escalonamento dinâmico por tiles (work stealing)
+    std::cout << "\n=== ESCALONADOR DINÂMICO (WORK STEALING) ===" << std::endl;
+    const TileShape shapes[] = { TileShape::ROWS, TileShape::TILES_2D, TileShape::INTERLEAVED };
+    std::vector<int> iterations_tiled(pixels);
+    
+    for (TileShape shape : shapes) {
+        SchedulerStats stats;
+        
+        const std::string shape_name = tile_shape_name(shape);
+        double serial_tiled_time =
+            measure_stats(timings, "work stealing", "Serial " + shape_name, pixels, num_threads, [&]() {
+                stats = process_tiled(iterations_tiled, params, mandelbrot_serial_tile, num_threads, shape);
+            }).median;
+        std::cout << "\nSerial + threads, " << tile_shape_name(shape) << ": "
+                  << serial_tiled_time << "s (speedup "
+                  << timing.serial_time / serial_tiled_time << "x)" << std::endl;
+        print_scheduler_stats(stats, serial_tiled_time);
+        
+        double simd_tiled_time =
+            measure_stats(timings, "work stealing", "SIMD " + shape_name, pixels, num_threads, [&]() {
+                stats = process_tiled(iterations_tiled, params, mandelbrot_simd_tile, num_threads, shape);
+            }).median;
+        double speedup = timing.serial_time / simd_tiled_time;
+        std::cout << "SIMD + threads, " << tile_shape_name(shape) << ": "
+                  << simd_tiled_time << "s (speedup " << speedup << "x, "
+                  << "eficiência paralela " << (speedup / num_threads) * 100 << "%)" << std::endl;
+        print_scheduler_stats(stats, simd_tiled_time);
+    }
+    
+    // Precisão simples com 8 e 16 lanes
+    std::cout << "\n=== PRECISÃO SIMPLES (8/16 LANES) ===" << std::endl;
+    std::vector<int> iterations_float(pixels);
+    const Tile full_image{0, params.width, 0, params.height, 1};
+    
+    double float_time = measure_stats(timings, "precisão simples", "SIMD float AVX2", pixels, 1, [&]() {
+        mandelbrot_simd_float_tile(iterations_float, params, full_image);
+    }).median;
+    std::cout << "Tempo SIMD float (AVX2, 8 lanes): " << float_time << "s (speedup vs SIMD double "
+              << timing.simd_time / float_time << "x, pixels diferentes: "
+              << count_mismatches(iterations_simd, iterations_float) << ")" << std::endl;
+    
+#ifdef __AVX512F__
+    double avx512_time = measure_stats(timings, "precisão simples", "SIMD float AVX-512", pixels, 1, [&]() {
+        mandelbrot_avx512_float_tile(iterations_float, params, full_image);
+    }).median;
+    std::cout << "Tempo SIMD float (AVX-512, 16 lanes): " << avx512_time << "s (speedup vs SIMD double "
+              << timing.simd_time / avx512_time << "x, pixels diferentes: "
+              << count_mismatches(iterations_simd, iterations_float) << ")" << std::endl;
+#else
+    std::cout << "AVX-512 indisponível nesta compilação" << std::endl;
+#endif
+    
+    std::cout << "Precisão simples suficiente para a vista: "
+              << (float_precision_sufficient(params, full_image) ? "sim" : "não (usa double)") << std::endl;
+    double auto_time = measure_stats(timings, "precisão simples", "Automática+threads", pixels, num_threads, [&]() {
+        process_tiled(iterations_float, params, mandelbrot_auto_tile, num_threads, TileShape::TILES_2D);
+    }).median;
+    std::cout << "Tempo seleção automática + threads (tiles 2D): " << auto_time << "s (speedup "
+              << timing.serial_time / auto_time << "x)" << std::endl;
+    
+    // Matriz de instanciações do kernel em template
+    std::cout << "\n=== MATRIZ DE INSTANCIAÇÕES ({float, double} x ISA x DESENROLAMENTO) ===" << std::endl;
+    if (!isa_enabled(Isa::AVX512)) {
+        std::cout << "AVX-512 não habilitado na compilação; essas instanciações ficam de fora" << std::endl;
+    }
+    std::ofstream matrix_csv("mandelbrot_matrix.csv");
+    matrix_csv << "Tipo,ISA,Desenrolamento,Threads,Escalonador,Tempo(s),Miterações/s,PixelsDiferentes\n";
+    run_kernel_matrix<float>(options, timings, matrix_csv);
+    run_kernel_matrix<double>(options, timings, matrix_csv);
+    std::cout << "Resultados salvos em mandelbrot_matrix.csv" << std::endl;
+    
+    // Recarga de lanes SIMD
+    std::cout << "\n=== RECARGA DE LANES SIMD ===" << std::endl;
+    std::vector<int> iterations_refill(pixels);
+    LaneStats refill_stats;
+    
+    // Ocupação de mandelbrot_simd contada dentro do kernel, nas mesmas faixas de linhas
+    // da versão com recarga (o resultado é sobrescrito por ela)
+    LaneStats simd_lane_stats;
+    for (int y = 0; y < params.height; y += TILE_HEIGHT) {
+        mandelbrot_tile_lanes<double, Isa::AVX2>(iterations_refill, params,
+                                                 Tile{0, params.width, y, std::min(y + TILE_HEIGHT, params.height), 1},
+                                                 &simd_lane_stats);
+    }
+    
+    // A ocupação é uma razão: acumular as execuções do harness não a altera
+    double refill_time = measure_stats(timings, "recarga", "SIMD com recarga", pixels, 1, [&]() {
+        for (int y = 0; y < params.height; y += TILE_HEIGHT) {
+            mandelbrot_simd_refill_tile(iterations_refill, params,
+                                        Tile{0, params.width, y, std::min(y + TILE_HEIGHT, params.height), 1},
+                                        refill_stats);
+        }
+    }).median;
+    std::cout << "Tempo SIMD: " << timing.simd_time << "s, ocupação das lanes: "
+              << simd_lane_stats.utilization() * 100 << "%" << std::endl;
+    std::cout << "Tempo SIMD com recarga: " << refill_time << "s (speedup "
+              << timing.simd_time / refill_time << "x), ocupação das lanes: "
+              << refill_stats.utilization() * 100 << "%" << std::endl;
+    std::cout << "Pixels diferentes da versão SIMD: "
+              << count_mismatches(iterations_simd, iterations_refill) << std::endl;
+    
+    LaneStats refill_threaded_stats;
+    SchedulerStats refill_sched_stats;
+    double refill_threaded_time =
+        measure_stats(timings, "recarga", "SIMD com recarga+threads", pixels, num_threads, [&]() {
+            refill_sched_stats = process_tiled(iterations_refill, params, [&](std::vector<int>& iters,
+                                                                              const RenderParams& p,
+                                                                              const Tile& tile) {
+                mandelbrot_simd_refill_tile(iters, p, tile, refill_threaded_stats);
+            }, num_threads, TileShape::TILES_2D);
+        }).median;
+    std::cout << "Tempo SIMD com recarga + threads (tiles 2D): " << refill_threaded_time
+              << "s (speedup " << timing.serial_time / refill_threaded_time << "x), ocupação das lanes: "
+              << refill_threaded_stats.utilization() * 100 << "%" << std::endl;
+    
+    // Subdivisão de retângulos (Mariani–Silver)
+    std::cout << "\n=== SUBDIVISÃO DE RETÂNGULOS (MARIANI–SILVER) ===" << std::endl;
+    std::vector<int> iterations_subdivided(pixels);
+    SchedulerStats subdivision_stats;
+    double iterated_fraction = 0.0;
+    
+    double subdivision_time = measure_stats(timings, "subdivisão", "SIMD+threads", pixels, num_threads, [&]() {
+        iterated_fraction = mandelbrot_subdivide(iterations_subdivided, params, num_threads, subdivision_stats);
+    }).median;
+    std::cout << "Tempo subdivisão SIMD + threads: " << subdivision_time << "s (speedup "
+              << timing.serial_time / subdivision_time << "x, vs SIMD + multi-thread "
+              << timing.simd_threaded_time / subdivision_time << "x)" << std::endl;
+    std::cout << "Pixels iterados: " << iterated_fraction * 100 << "%" << std::endl;
+    std::cout << "Pixels diferentes da versão SIMD: "
+              << count_mismatches(iterations_simd, iterations_subdivided) << std::endl;
+    print_scheduler_stats(subdivision_stats, subdivision_time);
+    
+    // Perturbação: órbita de referência em alta precisão + deltas em double
+    std::cout << "\n=== PERTURBAÇÃO (ZOOM PROFUNDO) ===" << std::endl;
+    std::vector<int> iterations_perturbation(pixels);
+    ReferenceOrbit orbit;
+    PerturbationStats perturbation_stats;
+    
+    double reference_time = measure_stats(timings, "perturbação", "Órbita de referência",
+                                          static_cast<size_t>(params.max_iterations), 1, [&]() {
+        orbit = compute_reference_orbit(options.center_x, options.center_y, params.max_iterations);
+    }).median;
+    double perturbation_time = measure_stats(timings, "perturbação", "SIMD+threads", pixels, num_threads, [&]() {
+        // Contagens de uma única renderização
+        perturbation_stats.rebases = 0;
+        perturbation_stats.glitches = 0;
+        process_tiled(iterations_perturbation, params, [&](std::vector<int>& iters,
+                                                           const RenderParams& p, const Tile& tile) {
+            mandelbrot_perturbation_tile(iters, p, tile, orbit, perturbation_stats);
+        }, num_threads, TileShape::TILES_2D);
+    }).median;
+    std::cout << "Órbita de referência: " << orbit.zx.size() - 1 << " iterações em "
+              << reference_time << "s" << std::endl;
+    std::cout << "Tempo perturbação SIMD + threads: " << perturbation_time << "s (vs SIMD + multi-thread "
+              << timing.simd_threaded_time / perturbation_time << "x)" << std::endl;
+    std::cout << "Rebases: " << perturbation_stats.rebases << " (glitches detectados: "
+              << perturbation_stats.glitches << ")" << std::endl;
+    std::cout << "Pixels diferentes da versão SIMD: "
+              << count_mismatches(iterations_simd, iterations_perturbation) << std::endl;
+    
+    // Double-double: mesma divisão por faixas do SIMD + multi-thread
+    std::cout << "\n=== DOUBLE-DOUBLE (PRECISÃO ESTENDIDA) ===" << std::endl;
+    std::vector<int> iterations_dd(pixels);
+    
+    double dd_time = measure_stats(timings, "double-double", "SIMD+Multi-thread", pixels, num_threads, [&]() {
+        process_threaded(iterations_dd, params, mandelbrot_dd, num_threads);
+    }).median;
+    double simd_mips = total_iterations(iterations_simd_threaded) / timing.simd_threaded_time / 1e6;
+    double dd_mips = total_iterations(iterations_dd) / dd_time / 1e6;
+    std::cout << "SIMD + multi-thread (double): " << simd_mips << " Miterações/s" << std::endl;
+    std::cout << "Double-double SIMD + multi-thread: " << dd_time << "s, " << dd_mips
+              << " Miterações/s (custo por iteração " << simd_mips / dd_mips << "x)" << std::endl;
+    std::cout << "Pixels diferentes da versão SIMD: "
+              << count_mismatches(iterations_simd, iterations_dd) << std::endl;
+    
+#ifdef HAVE_ISPC
+    // Código SPMD gerado pelo ISPC contra os intrínsecos escritos à mão
+    std::cout << "\n=== ISPC ===" << std::endl;
+    std::vector<int> iterations_ispc(pixels);
+    std::vector<int> iterations_ispc_tasks(pixels);
+    
+    double ispc_time = measure_stats(timings, "ispc", "ISPC", pixels, 1, [&]() {
+        mandelbrot_ispc(iterations_ispc, params, 0, params.height);
+    }).median;
+    double ispc_tasks_time = measure_stats(timings, "ispc", "ISPC+tasks", pixels, num_threads, [&]() {
+        mandelbrot_ispc_tasks(iterations_ispc_tasks, params, num_threads * INTERLEAVE_TASKS_PER_THREAD);
+    }).median;
+    std::cout << "Tempo ISPC: " << ispc_time << "s (speedup " << timing.serial_time / ispc_time
+              << "x, vs SIMD " << timing.simd_time / ispc_time << "x)" << std::endl;
+    std::cout << "Tempo ISPC + tasks: " << ispc_tasks_time << "s (speedup "
+              << timing.serial_time / ispc_tasks_time << "x, vs SIMD + multi-thread "
+              << timing.simd_threaded_time / ispc_tasks_time << "x)" << std::endl;
+    std::cout << "Pixels diferentes da versão SIMD: "
+              << count_mismatches(iterations_simd, iterations_ispc) << " (ISPC), "
+              << count_mismatches(iterations_simd, iterations_ispc_tasks) << " (ISPC + tasks)" << std::endl;
+#endif
+    
+    // Cache de tiles: percurso de pan/zoom com e sem reaproveitamento
+    std::cout << "\n=== CACHE DE TILES (PAN/ZOOM) ===" << std::endl;
+    run_pan_zoom_replay(options);
+    
+    // Colorização fundida aos workers de renderização
+    std::cout << "\n=== COLORIZAÇÃO FUNDIDA ===" << std::endl;
+    const std::vector<unsigned char> palette = build_palette(params.max_iterations);
+    std::vector<unsigned char> rgb(3 * pixels);
+    std::vector<int> iterations_fused(pixels);
+    
+    double separate_time = measure_stats(timings, "colorização", "Separada", pixels, num_threads, [&]() {
+        process_tiled(iterations_fused, params, mandelbrot_simd_tile, num_threads, TileShape::TILES_2D);
+        colorize_parallel(iterations_fused, rgb, palette, params, num_threads);
+    }).median;
+    double fused_time = measure_stats(timings, "colorização", "Fundida", pixels, num_threads, [&]() {
+        process_tiled(iterations_fused, params, make_colorizing_kernel(mandelbrot_simd_tile, rgb, palette),
+                      num_threads, TileShape::TILES_2D);
+    }).median;
+    std::cout << "SIMD + threads, cálculo e colorização separados: " << separate_time << "s" << std::endl;
+    std::cout << "SIMD + threads, colorização fundida: " << fused_time << "s (speedup "
+              << separate_time / fused_time << "x)" << std::endl;
     
     // Salvar imagens
     std::cout << "\nSalvando imagens..." << std::endl;
-    save_ppm(iterations_serial, "mandelbrot_serial.ppm");
-    save_ppm(iterations_simd, "mandelbrot_simd.ppm");
-    save_ppm(iterations_threaded, "mandelbrot_threaded.ppm");
-    save_ppm(iterations_simd_threaded, "mandelbrot_simd_threaded.ppm");
+    const std::vector<std::pair<std::vector<int>*, std::string>> images = {
+        {&iterations_serial, "mandelbrot_serial.ppm"},
+        {&iterations_simd, "mandelbrot_simd.ppm"},
+        {&iterations_threaded, "mandelbrot_threaded.ppm"},
+        {&iterations_simd_threaded, "mandelbrot_simd_threaded.ppm"}
+    };
+    
+    double colorize_time = 0.0, io_time = 0.0;
+    for (const auto& image : images) {
+        colorize_time += measure_time([&]() {
+            colorize_parallel(*image.first, rgb, palette, params, num_threads);
+        });
+        io_time += measure_time([&]() {
+            save_ppm(rgb, params, image.second);
+        });
+    }
     
+    std::cout << "Tempo de colorização: " << colorize_time << "s" << std::endl;
+    std::cout << "Tempo de I/O: " << io_time << "s" << std::endl;
     std::cout << "Imagens salvas como mandelbrot_*.ppm" << std::endl;
+}
+
+// Função principal
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (options.kernel != "subdivide" && options.kernel != "perturbation" &&
+        find_tile_kernel(options.kernel) == nullptr) {
+        std::cerr << "Kernel desconhecido: " << options.kernel << std::endl;
+        return 1;
+    }
+    
+    if (!options.serve_path.empty()) {
+        return run_tile_server(options);
+    } else if (!options.load_test_path.empty()) {
+        return run_load_test(options);
+    } else if (options.frames > 0) {
+        run_zoom_sequence(options);
+    } else if (options.render) {
+        run_single_render(options);
+    } else {
+        run_benchmark(options);
+    }
     
     return 0;
 }
\ No newline at end of file
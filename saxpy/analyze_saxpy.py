@@ -15,7 +15,7 @@ def run_experiment():
     if compile_result.returncode != 0:
         print("Erro na compilação:")
         print(compile_result.stderr)
-        return None, None
+        return None, None, None
     
     print("Executando experimento SAXPY...")
     result = subprocess.run(['./saxpy_experiment'], capture_output=True, text=True)
@@ -28,11 +28,12 @@ def run_experiment():
     # Ler resultados
     try:
         df_main = pd.read_csv('saxpy_results.csv')
-        df_scalability = pd.read_csv('saxpy_scalability.csv')
-        return df_main, df_scalability
+        df_sweep = pd.read_csv('saxpy_sweep.csv')
+        df_marks = pd.read_csv('saxpy_sweep_marks.csv')
+        return df_main, df_sweep, df_marks
     except FileNotFoundError as e:
         print(f"Arquivos de resultados não encontrados: {e}")
-        return None, None
+        return None, None, None
 
 def clean_numeric_columns(df):
     """Limpa colunas numéricas removendo caracteres não numéricos"""
@@ -43,15 +44,35 @@ def clean_numeric_columns(df):
             df[col] = pd.to_numeric(df[col], errors='coerce')
     return df
 
-def analyze_results(df_main, df_scalability):
+# Pares (multi-thread, single-thread) comparados no gráfico de speedup da varredura
+SWEEP_PAIRS = [('Multi-thread', 'Serial'), ('SIMD+Multi-thread', 'SIMD'),
+               ('SIMD+Multi-thread (stream)', 'SIMD (stream)')]
+
+def plot_sweep_marks(ax, df_marks):
+    """Linhas verticais nos tamanhos de cache e nos cruzamentos multi-thread"""
+    for _, mark in df_marks.iterrows():
+        if mark['Tipo'] == 'cache':
+            ax.axvline(mark['WorkingSet(B)'], color='gray', linestyle='--', alpha=0.7)
+            ax.text(mark['WorkingSet(B)'], 1.0, f" {mark['Marca']}", color='gray',
+                    transform=ax.get_xaxis_transform(), va='top')
+        else:
+            ax.axvline(mark['WorkingSet(B)'], color='red', linestyle=':', alpha=0.7)
+
+def sweep_speedup(df_sweep, threaded, single):
+    """Speedup de threaded sobre single em cada working set da varredura"""
+    by_variant = df_sweep.pivot(index='WorkingSet(B)', columns='Variante', values='Mediana(s)')
+    if threaded not in by_variant or single not in by_variant:
+        return None
+    return by_variant[single] / by_variant[threaded]
+
+def analyze_results(df_main, df_sweep, df_marks):
     """Analisa e plota os resultados"""
-    if df_main is None or df_scalability is None:
+    if df_main is None or df_sweep is None:
         print("Nenhum dado para analisar")
         return
     
     # Limpar colunas numéricas
     df_main = clean_numeric_columns(df_main)
-    df_scalability = clean_numeric_columns(df_scalability)
     
     # Configurar plots
     fig, ((ax1, ax2), (ax3, ax4)) = plt.subplots(2, 2, figsize=(16, 12))
@@ -88,33 +109,34 @@ def analyze_results(df_main, df_scalability):
         ax2.text(bar.get_x() + bar.get_width()/2., height + 0.1,
                 f'{bw:.2f} GB/s', ha='center', va='bottom')
     
-    # Gráfico 3: Escalabilidade de tempo
-    sizes_gb = df_scalability['Tamanho'] * 4 * 3 / (1024**3)  # Convert to GB
-    ax3.plot(sizes_gb, df_scalability['SerialTime'], 'o-', label='Serial', linewidth=2)
-    ax3.plot(sizes_gb, df_scalability['SIMDTime'], 'o-', label='SIMD', linewidth=2)
-    ax3.plot(sizes_gb, df_scalability['ThreadedTime'], 'o-', label='Multi-thread', linewidth=2)
-    ax3.plot(sizes_gb, df_scalability['SIMDThreadedTime'], 'o-', label='SIMD+Threaded', linewidth=2)
-    
-    ax3.set_xlabel('Tamanho dos Dados (GB)')
-    ax3.set_ylabel('Tempo de Execução (s)')
-    ax3.set_title('Escalabilidade de Tempo por Tamanho de Dados')
-    ax3.legend()
+    # Gráfico 3: Bandwidth por working set, com o intervalo de confiança da mediana
+    for variant, group in df_sweep.groupby('Variante', sort=False):
+        ax3.plot(group['WorkingSet(B)'], group['Bandwidth(GB/s)'], '.-', label=variant, linewidth=1.5)
+        ax3.fill_between(group['WorkingSet(B)'], group['BandwidthICInf(GB/s)'],
+                         group['BandwidthICSup(GB/s)'], alpha=0.2)
+    plot_sweep_marks(ax3, df_marks)
+    
+    ax3.set_xlabel('Working set (bytes)')
+    ax3.set_ylabel('Bandwidth (GB/s)')
+    ax3.set_title('Bandwidth por Working Set (L1/L2/LLC/DRAM)')
+    ax3.legend(fontsize='small')
     ax3.grid(True, alpha=0.3)
-    ax3.set_xscale('log')
-    ax3.set_yscale('log')
-    
-    # Gráfico 4: Escalabilidade de bandwidth
-    ax4.plot(sizes_gb, df_scalability['SerialBW'], 'o-', label='Serial', linewidth=2)
-    ax4.plot(sizes_gb, df_scalability['SIMDBW'], 'o-', label='SIMD', linewidth=2)
-    ax4.plot(sizes_gb, df_scalability['ThreadedBW'], 'o-', label='Multi-thread', linewidth=2)
-    ax4.plot(sizes_gb, df_scalability['SIMDThreadedBW'], 'o-', label='SIMD+Threaded', linewidth=2)
-    
-    ax4.set_xlabel('Tamanho dos Dados (GB)')
-    ax4.set_ylabel('Bandwidth (GB/s)')
-    ax4.set_title('Escalabilidade de Bandwidth por Tamanho de Dados')
-    ax4.legend()
+    ax3.set_xscale('log', base=2)
+    
+    # Gráfico 4: Speedup multi-thread sobre single-thread por working set
+    for threaded, single in SWEEP_PAIRS:
+        speedup = sweep_speedup(df_sweep, threaded, single)
+        if speedup is not None:
+            ax4.plot(speedup.index, speedup.values, '.-', label=f'{threaded} / {single}', linewidth=1.5)
+    ax4.axhline(1.0, color='black', linewidth=1)
+    plot_sweep_marks(ax4, df_marks)
+    
+    ax4.set_xlabel('Working set (bytes)')
+    ax4.set_ylabel('Speedup')
+    ax4.set_title('Speedup Multi-thread por Working Set')
+    ax4.legend(fontsize='small')
     ax4.grid(True, alpha=0.3)
-    ax4.set_xscale('log')
+    ax4.set_xscale('log', base=2)
     
     plt.tight_layout()
     plt.savefig('saxpy_analysis.png', dpi=300, bbox_inches='tight')
@@ -129,31 +151,27 @@ def analyze_results(df_main, df_scalability):
         bw = row['Bandwidth(GB/s)']
         print(f"{imp}: {speedup:.2f}x speedup, {bw:.2f} GB/s")
     
-    # Análise de eficiência - verificar se a coluna existe
-    if 'Eficiência(%)' in df_main.columns:
-        simd_efficiency = df_main[df_main['Implementação'] == 'SIMD']['Eficiência(%)'].values
-        threaded_efficiency = df_main[df_main['Implementação'] == 'Multi-thread']['Eficiência(%)'].values
-        
-        if len(simd_efficiency) > 0:
-            print(f"\nEficiência SIMD: {simd_efficiency[0]:.1f}%")
-        if len(threaded_efficiency) > 0:
-            print(f"Eficiência Threading: {threaded_efficiency[0]:.1f}%")
+    # Bandwidth em % da sonda STREAM - verificar se a coluna existe
+    if 'STREAM(%)' in df_main.columns:
+        print("\nBandwidth em % do STREAM:")
+        for _, row in df_main.iterrows():
+            print(f"{row['Implementação']}: {row['STREAM(%)']:.1f}%")
     else:
-        print("\nColuna de eficiência não encontrada nos resultados")
+        print("\nColuna STREAM(%) não encontrada nos resultados")
     
-    # Análise de escalabilidade
-    print("\nAnálise de escalabilidade:")
-    max_bw = df_scalability[['SerialBW', 'SIMDBW', 'ThreadedBW', 'SIMDThreadedBW']].max().max()
+    # Análise da varredura de working set
+    print("\nAnálise da varredura de working set:")
+    max_bw = df_sweep['Bandwidth(GB/s)'].max()
     print(f"Bandwidth máximo alcançado: {max_bw:.2f} GB/s")
     
-    # Calcular speedups médios da escalabilidade
-    avg_speedup_simd = (df_scalability['SerialTime'] / df_scalability['SIMDTime']).mean()
-    avg_speedup_threaded = (df_scalability['SerialTime'] / df_scalability['ThreadedTime']).mean()
-    avg_speedup_combined = (df_scalability['SerialTime'] / df_scalability['SIMDThreadedTime']).mean()
+    tier_bw = df_sweep.pivot_table(index='Variante', columns='Nível', values='Bandwidth(GB/s)',
+                                   aggfunc='median', sort=False)
+    print("Bandwidth mediana por nível (GB/s):")
+    print(tier_bw.round(2).to_string())
     
-    print(f"Speedup médio SIMD: {avg_speedup_simd:.2f}x")
-    print(f"Speedup médio Threaded: {avg_speedup_threaded:.2f}x")
-    print(f"Speedup médio Combinado: {avg_speedup_combined:.2f}x")
+    crossovers = df_marks[df_marks['Tipo'] == 'cruzamento']
+    for _, mark in crossovers.iterrows():
+        print(f"Cruzamento {mark['Marca']}: {mark['WorkingSet(B)'] / 1024:.0f} KiB")
     
     # Salvar relatório
     with open('saxpy_analysis_report.txt', 'w') as f:
@@ -167,16 +185,19 @@ def analyze_results(df_main, df_scalability):
             bw = row['Bandwidth(GB/s)']
             f.write(f"{imp}: Speedup={speedup:.2f}x, BW={bw:.2f} GB/s\n")
         
-        f.write("\nANÁLISE DE ESCALABILIDADE:\n")
-        f.write(f"Speedup médio SIMD: {avg_speedup_simd:.2f}x\n")
-        f.write(f"Speedup médio Threaded: {avg_speedup_threaded:.2f}x\n")
-        f.write(f"Speedup médio Combinado: {avg_speedup_combined:.2f}x\n")
+        f.write("\nVARREDURA DE WORKING SET:\n")
         f.write(f"Bandwidth máximo: {max_bw:.2f} GB/s\n")
+        f.write("Bandwidth mediana por nível (GB/s):\n")
+        f.write(tier_bw.round(2).to_string() + "\n")
+        if crossovers.empty:
+            f.write("Multi-thread não compensa na faixa medida\n")
+        for _, mark in crossovers.iterrows():
+            f.write(f"Cruzamento {mark['Marca']}: {mark['WorkingSet(B)'] / 1024:.0f} KiB\n")
         
         f.write("\nOBSERVAÇÕES:\n")
         f.write("1. A operação SAXPY é limitada por bandwidth de memória\n")
         f.write("2. SIMD sozinho pode não mostrar grande melhoria devido ao bottleneck de memória\n")
-        f.write("3. Multi-threading ajuda a saturar o bandwidth disponível\n")
+        f.write("3. Multi-threading ajuda a saturar o bandwidth disponível, mas só compensa acima do cruzamento\n")
         f.write("4. A combinação SIMD+threading maximiza o aproveitamento de recursos\n")
         f.write("5. Resultados podem variar com diferentes arquiteturas de memória\n")
 
@@ -185,19 +206,19 @@ def main():
     print("=== ANÁLISE DO EXPERIMENTO SAXPY ===")
     
     # Executar experimento
-    df_main, df_scalability = run_experiment()
+    df_main, df_sweep, df_marks = run_experiment()
     
-    if df_main is not None and df_scalability is not None:
+    if df_main is not None and df_sweep is not None:
         # Analisar resultados
-        analyze_results(df_main, df_scalability)
+        analyze_results(df_main, df_sweep, df_marks)
         
         # Mostrar resultados
         print("\n=== RESULTADOS DETALHADOS ===")
         print("Resultados principais:")
         print(df_main.to_string(index=False))
         
-        print("\nDados de escalabilidade:")
-        print(df_scalability.to_string(index=False))
+        print("\nDados da varredura de working set:")
+        print(df_sweep.to_string(index=False))
     
     print("Análise concluída!")
 
@@ -1,19 +1,94 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <random>
+#include <cstdlib>
 #include <chrono>
 #include <thread>
 #include <immintrin.h>
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <cstdint>
+#include <string>
+#include <functional>
+#include <iomanip>
+#include <type_traits>
+#include <unistd.h>
+
+#include "../common/aligned_allocator.h"
+#include "../common/numa.h"
+#include "../common/random.h"
+#include "../common/verify.h"
+#include "../common/blas1.h"
+#include "../common/roofline.h"
+#include "../common/perf_counters.h"
+#include "../common/benchmark.h"
+#include "../common/sweep.h"
+#include "../common/half.h"
+#include "../common/simd.h"
+
+#ifdef HAVE_ISPC
+#include "saxpy_ispc.h"
+#endif
 
 // Configurações
 const size_t VECTOR_SIZE = 100000000; // 100 milhões de elementos
-const int NUM_TRIALS = 10;
 const int NUM_THREADS = std::thread::hardware_concurrency();
 const float ALPHA = 2.5f; // Valor constante para o saxpy
+const float BETA = 0.5f;  // Coeficiente da segunda etapa da cadeia fundida (z = beta * y + z)
+const int DISPATCH_CALLS = 1000; // Chamadas vazias para medir o custo de despacho
+const float DATA_RANGE = 1000.0f; // x e y são sorteados em [-DATA_RANGE, DATA_RANGE]
+
+// Reduções: acumuladores vetoriais por thread e elementos por bloco do modo pairwise
+const int REDUCTION_ACCUMULATORS = 4;
+const size_t REDUCTION_BLOCK = 4096;
+
+// Trabalho por elemento do SAXPY para o roofline: uma multiplicação e uma soma, lendo
+// x e y e escrevendo y
+const double SAXPY_FLOPS_PER_ELEMENT = 2.0;
+const double SAXPY_BYTES_PER_ELEMENT = 3.0 * sizeof(float);
+
+// Matriz de instanciações: um tamanho que cabe na L2, onde o conjunto de instruções e o
+// desenrolamento pesam, e um bem maior que a LLC, onde todos convergem para a bandwidth
+const size_t MATRIX_SIZES[] = {size_t(1) << 14, size_t(1) << 25};
+const double MATRIX_MIN_TIME = 0.1;  // Limite de --min-time por instanciação
+
+// Semente dos dados (--seed); sem a opção é sorteada e impressa para repetir a execução
+uint64_t data_seed = 0;
+
+// Distância máxima da referência em double: as versões em C++ usam FMA (arredondamento único)
+const uint32_t SAXPY_MAX_ULPS = 1;
+
+// O ISPC não contrai alpha * x + y em FMA como o g++; com cancelamento (alpha * x ~ -y) o
+// arredondamento do produto vira muitos ULPs do resultado, então também se aceita um erro
+// absoluto de até 1 ulp dos operandos (~2.4e-4 para |alpha * x| ~ 2500)
+const float ISPC_TOLERANCE = 1e-3f;
+
+// Limiar para stores não temporais quando o sistema não informa o tamanho da LLC
+const size_t DEFAULT_LLC_SIZE = 32 * 1024 * 1024;
+
+// Tipo de store dos kernels SIMD: AUTO usa stores não temporais quando x e y
+// juntos não cabem na LLC
+enum class StoreMode {
+    AUTO,
+    REGULAR,
+    STREAMING
+};
+
+// Tamanho da cache de último nível (L3), ou DEFAULT_LLC_SIZE se desconhecido
+size_t llc_size() {
+    static const size_t size = []() {
+        long reported = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        return reported > 0 ? static_cast<size_t>(reported) : DEFAULT_LLC_SIZE;
+    }();
+    return size;
+}
+
+template<typename T = float>
+bool use_streaming_stores(size_t size, StoreMode mode) {
+    if (mode == StoreMode::AUTO) return 2 * size * sizeof(T) > llc_size();
+    return mode == StoreMode::STREAMING;
+}
 
 // Estrutura para resultados
 struct BenchmarkResult {
@@ -28,278 +103,666 @@ struct BenchmarkResult {
     double speedup_simd;
     double speedup_threaded;
     double speedup_simd_threaded;
-    double efficiency_simd;
-    double efficiency_threaded;
+    double ispc_time;
+    double ispc_tasks_time;
+    double bandwidth_ispc;        // GB/s
+    double bandwidth_ispc_tasks;  // GB/s
+    PerfSample serial_counters;   // Contadores de hardware de cada versão
+    PerfSample simd_counters;
+    PerfSample threaded_counters;
+    PerfSample simd_threaded_counters;
+    PerfSample ispc_counters;
+    PerfSample ispc_tasks_counters;  // Sempre indisponível: as tarefas do ISPC criam threads próprias
 };
 
-// Gerar vetores de dados aleatórios
-void generate_data(std::vector<float>& x, std::vector<float>& y, size_t size) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(-1000.0f, 1000.0f);
+// Gerar vetores de dados aleatórios com o Philox (fluxo 0 para x, 1 para y). A geração
+// é paralela, com o particionamento das threads de cálculo, e faz o first-touch NUMA.
+// Retorna o tempo gasto.
+double generate_data(FloatVector& x, FloatVector& y) {
+    auto start = std::chrono::high_resolution_clock::now();
+    fill_uniform(x, -DATA_RANGE, DATA_RANGE, data_seed, 0, NUM_THREADS);
+    fill_uniform(y, -DATA_RANGE, DATA_RANGE, data_seed, 1, NUM_THREADS);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Resultado esperado calculado com FMA em double: em float, alpha * x é exato em double,
+// então só há os arredondamentos da soma, e o valor fica a no máximo 1 ULP do FMA em
+// float; em double é o resultado corretamente arredondado
+template<typename T>
+AlignedVector<T> axpy_reference(T alpha, const AlignedVector<T>& x, const AlignedVector<T>& y) {
+    AlignedVector<T> expected(x.size());
+    for_each_thread_chunk(x.size(), NUM_THREADS, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            expected[i] = static_cast<T>(std::fma(static_cast<double>(alpha), static_cast<double>(x[i]),
+                                                  static_cast<double>(y[i])));
+        }
+    });
+    return expected;
+}
+
+// Verificar um resultado contra a referência e imprimir o resumo
+bool check_result(const std::string& name, const FloatVector& expected, const FloatVector& result,
+                  float abs_tolerance = 0.0f) {
+    VerifyResult verification = verify_buffers(expected, result, SAXPY_MAX_ULPS, abs_tolerance, NUM_THREADS);
+    print_verification("  Verificação " + name, verification);
+    return verification.ok();
+}
+
+// AXPY vetorial sobre [i, end) em grupos de Unroll vetores independentes e depois de um
+// vetor; devolve onde parou. Com Streaming, y é escrito com stores não temporais.
+template<typename T, Isa I, int Unroll, bool Streaming>
+size_t axpy_vectors(T alpha, const T* x, T* y, size_t i, size_t end) {
+    using S = Simd<T, I>;
+    const typename S::Vec alpha_vec = S::set1(alpha);
     
-    for (size_t i = 0; i < size; ++i) {
-        x[i] = dis(gen);
-        y[i] = dis(gen);
+    for (; i + S::lanes * Unroll <= end; i += S::lanes * Unroll) {
+        typename S::Vec result[Unroll];
+        for (int u = 0; u < Unroll; u++) {
+            const size_t j = i + u * S::lanes;
+            result[u] = S::fmadd(alpha_vec, S::load(&x[j]), S::load(&y[j]));  // y = alpha * x + y
+        }
+        for (int u = 0; u < Unroll; u++) {
+            if constexpr (Streaming) S::stream(&y[i + u * S::lanes], result[u]);
+            else S::store(&y[i + u * S::lanes], result[u]);
+        }
+    }
+    for (; i + S::lanes <= end; i += S::lanes) {
+        const typename S::Vec result = S::fmadd(alpha_vec, S::load(&x[i]), S::load(&y[i]));
+        if constexpr (Streaming) S::stream(&y[i], result);
+        else S::store(&y[i], result);
     }
+    return i;
 }
 
-// Verificar resultados (deve ser y = alpha * x + y)
-bool verify_results(const std::vector<float>& x, const std::vector<float>& y, 
-                   const std::vector<float>& result, float alpha, float tolerance = 1e-6f) {
-    for (size_t i = 0; i < x.size(); ++i) {
-        float expected = alpha * x[i] + y[i];
-        if (std::abs(result[i] - expected) > tolerance) {
-            std::cout << "Erro na posição " << i << ": esperado " << expected 
-                      << ", obtido " << result[i] << std::endl;
-            return false;
+// AXPY sobre [begin, end) para qualquer tipo, conjunto de instruções e desenrolamento. Com
+// streaming (só nas versões vetoriais) as primeiras posições são tratadas em escalar até y
+// ficar alinhado para o stream, e o sfence ordena os stores antes do retorno.
+template<typename T, Isa I, int Unroll = 1>
+void axpy_range(T alpha, const T* x, T* y, size_t begin, size_t end, bool streaming) {
+    size_t i = begin;
+    if (I != Isa::SCALAR && streaming) {
+        for (; i < end && reinterpret_cast<uintptr_t>(&y[i]) % Simd<T, I>::alignment != 0; ++i) {
+            y[i] = alpha * x[i] + y[i];
         }
+        i = axpy_vectors<T, I, Unroll, true>(alpha, x, y, i, end);
+        _mm_sfence();
+    } else {
+        i = axpy_vectors<T, I, Unroll, false>(alpha, x, y, i, end);
+    }
+    
+    // Processar elementos restantes serialmente
+    for (; i < end; ++i) {
+        y[i] = alpha * x[i] + y[i];
     }
-    return true;
 }
 
-// SAXPY serial (implementação de referência)
-void saxpy_serial(float alpha, const std::vector<float>& x, std::vector<float>& y) {
-    for (size_t i = 0; i < x.size(); ++i) {
-        y[i] = alpha * x[i] + y[i];
+// AXPY (y = alpha * x + y) da instanciação <T, I, Unroll>. Com num_threads = 0 roda na
+// thread que chama; senão em blocos de thread_chunk no pool, os mesmos do first-touch,
+// que começam em linhas de cache, o que os stores não temporais exigem.
+template<typename T, Isa I, int Unroll = 1>
+void axpy(T alpha, Slice<const T> x, Slice<T> y, int num_threads = 0, StoreMode mode = StoreMode::REGULAR) {
+    const bool streaming = use_streaming_stores<T>(x.size(), mode);
+    if (num_threads == 0) {
+        axpy_range<T, I, Unroll>(alpha, x.data(), y.data(), 0, x.size(), streaming);
+        return;
     }
+    for_each_thread_chunk(x.size(), num_threads, [&](size_t start, size_t end) {
+        axpy_range<T, I, Unroll>(alpha, x.data(), y.data(), start, end, streaming);
+    });
+}
+
+// SAXPY serial (implementação de referência)
+void saxpy_serial(float alpha, ConstFloatSlice x, FloatSlice y) {
+    axpy<float, Isa::SCALAR>(alpha, x, y);
 }
 
 // SAXPY com SIMD (AVX2)
-void saxpy_simd(float alpha, const std::vector<float>& x, std::vector<float>& y) {
-    const size_t size = x.size();
-    const size_t simd_size = size - (size % 8); // AVX2 processa 8 floats por vez
-    
+void saxpy_simd(float alpha, ConstFloatSlice x, FloatSlice y, StoreMode mode = StoreMode::AUTO) {
+    axpy<float, Isa::AVX2>(alpha, x, y, 0, mode);
+}
+
+// SAXPY multi-thread
+void saxpy_threaded(float alpha, ConstFloatSlice x, FloatSlice y, int num_threads) {
+    axpy<float, Isa::SCALAR>(alpha, x, y, num_threads);
+}
+
+// SAXPY SIMD + multi-thread
+void saxpy_simd_threaded(float alpha, ConstFloatSlice x, FloatSlice y, int num_threads,
+                         StoreMode mode = StoreMode::AUTO) {
+    axpy<float, Isa::AVX2>(alpha, x, y, num_threads, mode);
+}
+
+// SAXPY SIMD + multi-thread criando as threads a cada chamada (para medir o custo
+// de despacho em relação ao pool)
+void saxpy_simd_threaded_spawn(float alpha, ConstFloatSlice x, FloatSlice y, int num_threads) {
+    for_each_thread_chunk_spawn(x.size(), num_threads, [&](size_t start, size_t end) {
+        axpy_range<float, Isa::AVX2>(alpha, x.data(), y.data(), start, end, false);
+    });
+}
+
+// SAXPY AVX2 sobre [begin, end) com x e y guardados em 16 bits (Float16 ou BFloat16):
+// cada grupo de 8 é convertido para float, calculado com FMA em fp32 e arredondado de
+// volta no store
+template<typename Storage>
+void saxpy_reduced_range(float alpha, const Storage* x, Storage* y, size_t begin, size_t end) {
+    size_t i = begin;
     __m256 alpha_vec = _mm256_set1_ps(alpha);
-    
-    // Processar blocos de 8 elementos
-    for (size_t i = 0; i < simd_size; i += 8) {
-        __m256 x_vec = _mm256_loadu_ps(&x[i]);
-        __m256 y_vec = _mm256_loadu_ps(&y[i]);
-        
-        // y = alpha * x + y
-        __m256 result = _mm256_fmadd_ps(alpha_vec, x_vec, y_vec);
-        _mm256_storeu_ps(&y[i], result);
+    for (; i + 8 <= end; i += 8) {
+        store_float8(&y[i], _mm256_fmadd_ps(alpha_vec, load_float8(&x[i]), load_float8(&y[i])));
     }
-    
-    // Processar elementos restantes serialmente
-    for (size_t i = simd_size; i < size; ++i) {
-        y[i] = alpha * x[i] + y[i];
+    for (; i < end; ++i) {
+        store_float(&y[i], std::fma(alpha, load_float(&x[i]), load_float(&y[i])));
     }
 }
 
-// SAXPY multi-thread
-void saxpy_threaded(float alpha, const std::vector<float>& x, std::vector<float>& y, int num_threads) {
-    std::vector<std::thread> threads;
-    const size_t chunk_size = x.size() / num_threads;
-    
-    for (int i = 0; i < num_threads; ++i) {
-        size_t start = i * chunk_size;
-        size_t end = (i == num_threads - 1) ? x.size() : start + chunk_size;
-        
-        threads.emplace_back([&, start, end]() {
-            for (size_t j = start; j < end; ++j) {
-                y[j] = alpha * x[j] + y[j];
-            }
-        });
+// SAXPY SIMD + multi-thread com armazenamento em 16 bits: metade dos bytes por elemento.
+// Os blocos de thread_chunk (múltiplos de 16 elementos) começam em meia linha de cache,
+// o que só divide uma linha entre duas threads nas bordas dos blocos.
+template<typename Storage>
+void saxpy_simd_threaded_reduced(float alpha, Slice<const Storage> x, Slice<Storage> y, int num_threads) {
+    for_each_thread_chunk(x.size(), num_threads, [&](size_t start, size_t end) {
+        saxpy_reduced_range(alpha, x.data(), y.data(), start, end);
+    });
+}
+
+// Modo de soma das reduções: acumuladores simples, compensada (Kahan) ou em árvore
+// sobre blocos de REDUCTION_BLOCK elementos (pairwise)
+enum class SumMode {
+    PLAIN,
+    KAHAN,
+    PAIRWISE
+};
+
+const char* sum_mode_name(SumMode mode) {
+    switch (mode) {
+        case SumMode::PLAIN: return "simples";
+        case SumMode::KAHAN: return "Kahan";
+        case SumMode::PAIRWISE: return "pairwise";
+    }
+    return "";
+}
+
+// Reduções do BLAS-1: sdot (soma de x * y), snrm2 (raiz da soma de x^2) e sasum (soma de |x|)
+enum class ReductionKind {
+    DOT,
+    NRM2,
+    ASUM
+};
+
+// Soma em árvore de uma sequência de valores, como num contador binário: o k-ésimo valor
+// é combinado com os anteriores conforme os bits de k. A ordem é fixa e a memória O(log n).
+template<typename T>
+class PairwiseSum {
+public:
+    void add(T value) {
+        int level = 0;
+        for (size_t count = count_; count & 1; count >>= 1, level++) {
+            value = levels_[level] + value;
+        }
+        levels_[level] = value;
+        count_++;
     }
     
-    for (auto& thread : threads) {
-        thread.join();
+    T total() const {
+        T sum = 0;
+        for (int level = 0; level < 64; level++) {
+            if ((count_ >> level) & 1) sum = levels_[level] + sum;
+        }
+        return sum;
     }
+    
+private:
+    T levels_[64] = {};
+    size_t count_ = 0;
+};
+
+template<ReductionKind kind>
+inline float reduction_term(const float* x, const float* y, size_t i) {
+    if constexpr (kind == ReductionKind::DOT) return x[i] * y[i];
+    else if constexpr (kind == ReductionKind::NRM2) return x[i] * x[i];
+    else return std::abs(x[i]);
 }
 
-// SAXPY SIMD + multi-thread
-void saxpy_simd_threaded(float alpha, const std::vector<float>& x, std::vector<float>& y, int num_threads) {
-    std::vector<std::thread> threads;
-    const size_t total_size = x.size();
-    const size_t chunk_size = (total_size + num_threads - 1) / num_threads;
-    
-    for (int i = 0; i < num_threads; ++i) {
-        size_t start = i * chunk_size;
-        size_t end = std::min(start + chunk_size, total_size);
-        
-        threads.emplace_back([&, start, end]() {
-            const size_t local_size = end - start;
-            const size_t simd_size = local_size - (local_size % 8);
-            
-            __m256 alpha_vec = _mm256_set1_ps(alpha);
-            
-            for (size_t j = start; j < start + simd_size; j += 8) {
-                __m256 x_vec = _mm256_loadu_ps(&x[j]);
-                __m256 y_vec = _mm256_loadu_ps(&y[j]);
-                
-                __m256 result = _mm256_fmadd_ps(alpha_vec, x_vec, y_vec);
-                _mm256_storeu_ps(&y[j], result);
-            }
-            
-            for (size_t j = start + simd_size; j < end; ++j) {
-                y[j] = alpha * x[j] + y[j];
-            }
-        });
+template<ReductionKind kind>
+inline __m256 reduction_term_simd(const float* x, const float* y, size_t i) {
+    __m256 x_vec = _mm256_loadu_ps(&x[i]);
+    if constexpr (kind == ReductionKind::DOT) return _mm256_mul_ps(x_vec, _mm256_loadu_ps(&y[i]));
+    else if constexpr (kind == ReductionKind::NRM2) return _mm256_mul_ps(x_vec, x_vec);
+    else return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x_vec);
+}
+
+// acc + termo, com FMA para sdot e snrm2
+template<ReductionKind kind>
+inline __m256 reduction_accumulate_simd(__m256 acc, const float* x, const float* y, size_t i) {
+    __m256 x_vec = _mm256_loadu_ps(&x[i]);
+    if constexpr (kind == ReductionKind::DOT) return _mm256_fmadd_ps(x_vec, _mm256_loadu_ps(&y[i]), acc);
+    else if constexpr (kind == ReductionKind::NRM2) return _mm256_fmadd_ps(x_vec, x_vec, acc);
+    else return _mm256_add_ps(acc, _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x_vec));
+}
+
+// Soma das 8 lanes em árvore
+inline float horizontal_sum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+// Redução escalar de [begin, end)
+template<ReductionKind kind>
+float reduce_serial_range(const float* x, const float* y, size_t begin, size_t end, SumMode mode) {
+    if (mode == SumMode::KAHAN) {
+        float sum = 0.0f, compensation = 0.0f;
+        for (size_t i = begin; i < end; ++i) {
+            float term = reduction_term<kind>(x, y, i) - compensation;
+            float next = sum + term;
+            compensation = (next - sum) - term;
+            sum = next;
+        }
+        return sum;
     }
     
-    for (auto& thread : threads) {
-        thread.join();
+    const size_t block = mode == SumMode::PAIRWISE ? REDUCTION_BLOCK : end - begin;
+    PairwiseSum<float> tree;
+    for (size_t first = begin; first < end; first += block) {
+        const size_t last = std::min(first + block, end);
+        float sum = 0.0f;
+        for (size_t i = first; i < last; ++i) {
+            sum += reduction_term<kind>(x, y, i);
+        }
+        tree.add(sum);
     }
+    return tree.total();
 }
 
-// Medir tempo de execução e bandwidth
-template<typename Func>
-double measure_time_and_bandwidth(Func func, size_t data_size_bytes, double& bandwidth) {
-    auto start = std::chrono::high_resolution_clock::now();
-    func();
-    auto end = std::chrono::high_resolution_clock::now();
+// Redução AVX2 de [begin, end) com REDUCTION_ACCUMULATORS acumuladores independentes,
+// para esconder a latência da FMA; acumuladores e lanes são combinados em árvore
+template<ReductionKind kind>
+float reduce_simd_block(const float* x, const float* y, size_t begin, size_t end) {
+    __m256 acc[REDUCTION_ACCUMULATORS];
+    for (int k = 0; k < REDUCTION_ACCUMULATORS; k++) acc[k] = _mm256_setzero_ps();
     
-    double time_seconds = std::chrono::duration<double>(end - start).count();
-    bandwidth = (data_size_bytes / (1024.0 * 1024.0 * 1024.0)) / time_seconds; // GB/s
+    size_t i = begin;
+    for (; i + 8 * REDUCTION_ACCUMULATORS <= end; i += 8 * REDUCTION_ACCUMULATORS) {
+        for (int k = 0; k < REDUCTION_ACCUMULATORS; k++) {
+            acc[k] = reduction_accumulate_simd<kind>(acc[k], x, y, i + 8 * k);
+        }
+    }
+    for (; i + 8 <= end; i += 8) {
+        acc[0] = reduction_accumulate_simd<kind>(acc[0], x, y, i);
+    }
     
-    return time_seconds;
+    for (int width = REDUCTION_ACCUMULATORS / 2; width > 0; width /= 2) {
+        for (int k = 0; k < width; k++) acc[k] = _mm256_add_ps(acc[k], acc[k + width]);
+    }
+    float sum = horizontal_sum(acc[0]);
+    for (; i < end; ++i) {
+        sum += reduction_term<kind>(x, y, i);
+    }
+    return sum;
 }
 
-// Executar benchmark múltiplas vezes
-template<typename Func>
-BenchmarkResult run_benchmark(Func benchmark_func, const std::string& name) {
-    std::vector<double> times;
-    std::vector<double> bandwidths;
-    
-    for (int i = 0; i < NUM_TRIALS; ++i) {
-        double bandwidth;
-        double time = measure_time_and_bandwidth([&]() { benchmark_func(); }, 
-                                               VECTOR_SIZE * sizeof(float) * 3, // x, y, e resultado
-                                               bandwidth);
-        times.push_back(time);
-        bandwidths.push_back(bandwidth);
+template<ReductionKind kind>
+float reduce_simd_range(const float* x, const float* y, size_t begin, size_t end, SumMode mode) {
+    if (mode == SumMode::KAHAN) {
+        __m256 sum[REDUCTION_ACCUMULATORS], compensation[REDUCTION_ACCUMULATORS];
+        for (int k = 0; k < REDUCTION_ACCUMULATORS; k++) {
+            sum[k] = _mm256_setzero_ps();
+            compensation[k] = _mm256_setzero_ps();
+        }
+        
+        size_t i = begin;
+        for (; i + 8 * REDUCTION_ACCUMULATORS <= end; i += 8 * REDUCTION_ACCUMULATORS) {
+            for (int k = 0; k < REDUCTION_ACCUMULATORS; k++) {
+                __m256 term = _mm256_sub_ps(reduction_term_simd<kind>(x, y, i + 8 * k), compensation[k]);
+                __m256 next = _mm256_add_ps(sum[k], term);
+                compensation[k] = _mm256_sub_ps(_mm256_sub_ps(next, sum[k]), term);
+                sum[k] = next;
+            }
+        }
+        
+        // Lanes e elementos restantes entram numa soma de Kahan escalar
+        alignas(32) float lanes[8];
+        float total = 0.0f, total_compensation = 0.0f;
+        auto add = [&](float value) {
+            float term = value - total_compensation;
+            float next = total + term;
+            total_compensation = (next - total) - term;
+            total = next;
+        };
+        for (int k = 0; k < REDUCTION_ACCUMULATORS; k++) {
+            _mm256_store_ps(lanes, sum[k]);
+            for (float lane : lanes) add(lane);
+            _mm256_store_ps(lanes, compensation[k]);
+            for (float lane : lanes) add(-lane);
+        }
+        for (; i < end; ++i) {
+            add(reduction_term<kind>(x, y, i));
+        }
+        return total;
     }
     
-    // Remover outliers (máximo e mínimo)
-    auto min_max = std::minmax_element(times.begin(), times.end());
-    times.erase(min_max.first);
-    times.erase(min_max.second);
+    if (mode == SumMode::PAIRWISE) {
+        PairwiseSum<float> tree;
+        for (size_t first = begin; first < end; first += REDUCTION_BLOCK) {
+            tree.add(reduce_simd_block<kind>(x, y, first, std::min(first + REDUCTION_BLOCK, end)));
+        }
+        return tree.total();
+    }
     
-    min_max = std::minmax_element(bandwidths.begin(), bandwidths.end());
-    bandwidths.erase(min_max.first);
-    bandwidths.erase(min_max.second);
+    return reduce_simd_block<kind>(x, y, begin, end);
+}
+
+// Redução multi-thread: cada thread reduz o seu bloco de thread_chunk e as parciais são
+// combinadas em árvore, na ordem dos blocos, então o resultado não depende do escalonamento
+template<ReductionKind kind, bool simd>
+double reduce_threaded(const FloatVector& x, const FloatVector& y, int num_threads, SumMode mode) {
+    size_t first_start, chunk_size;
+    thread_chunk(x.size(), num_threads, 0, first_start, chunk_size);
+    if (chunk_size == 0) return 0.0;
     
-    BenchmarkResult result;
-    result.serial_time = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
-    result.bandwidth_serial = std::accumulate(bandwidths.begin(), bandwidths.end(), 0.0) / bandwidths.size();
+    std::vector<double> partials(num_threads, 0.0);
+    for_each_thread_chunk(x.size(), num_threads, [&](size_t start, size_t end) {
+        partials[start / chunk_size] = simd ? reduce_simd_range<kind>(x.data(), y.data(), start, end, mode)
+                                            : reduce_serial_range<kind>(x.data(), y.data(), start, end, mode);
+    });
     
-    return result;
+    PairwiseSum<double> tree;
+    for (double partial : partials) tree.add(partial);
+    return tree.total();
+}
+
+// sdot: soma de x * y
+float sdot_serial(const FloatVector& x, const FloatVector& y, SumMode mode = SumMode::PLAIN) {
+    return reduce_serial_range<ReductionKind::DOT>(x.data(), y.data(), 0, x.size(), mode);
+}
+
+float sdot_simd(const FloatVector& x, const FloatVector& y, SumMode mode = SumMode::PLAIN) {
+    return reduce_simd_range<ReductionKind::DOT>(x.data(), y.data(), 0, x.size(), mode);
+}
+
+float sdot_threaded(const FloatVector& x, const FloatVector& y, int num_threads, SumMode mode = SumMode::PLAIN) {
+    return static_cast<float>(reduce_threaded<ReductionKind::DOT, false>(x, y, num_threads, mode));
+}
+
+float sdot_simd_threaded(const FloatVector& x, const FloatVector& y, int num_threads,
+                         SumMode mode = SumMode::PLAIN) {
+    return static_cast<float>(reduce_threaded<ReductionKind::DOT, true>(x, y, num_threads, mode));
+}
+
+// snrm2: norma euclidiana de x (sem o reescalonamento do BLAS de referência, que só
+// importa perto do limite do float; os dados aqui ficam em +-1000)
+float snrm2_serial(const FloatVector& x, SumMode mode = SumMode::PLAIN) {
+    return std::sqrt(reduce_serial_range<ReductionKind::NRM2>(x.data(), x.data(), 0, x.size(), mode));
+}
+
+float snrm2_simd(const FloatVector& x, SumMode mode = SumMode::PLAIN) {
+    return std::sqrt(reduce_simd_range<ReductionKind::NRM2>(x.data(), x.data(), 0, x.size(), mode));
+}
+
+float snrm2_threaded(const FloatVector& x, int num_threads, SumMode mode = SumMode::PLAIN) {
+    return static_cast<float>(std::sqrt(reduce_threaded<ReductionKind::NRM2, false>(x, x, num_threads, mode)));
+}
+
+float snrm2_simd_threaded(const FloatVector& x, int num_threads, SumMode mode = SumMode::PLAIN) {
+    return static_cast<float>(std::sqrt(reduce_threaded<ReductionKind::NRM2, true>(x, x, num_threads, mode)));
+}
+
+// sasum: soma de |x|
+float sasum_serial(const FloatVector& x, SumMode mode = SumMode::PLAIN) {
+    return reduce_serial_range<ReductionKind::ASUM>(x.data(), x.data(), 0, x.size(), mode);
+}
+
+float sasum_simd(const FloatVector& x, SumMode mode = SumMode::PLAIN) {
+    return reduce_simd_range<ReductionKind::ASUM>(x.data(), x.data(), 0, x.size(), mode);
+}
+
+float sasum_threaded(const FloatVector& x, int num_threads, SumMode mode = SumMode::PLAIN) {
+    return static_cast<float>(reduce_threaded<ReductionKind::ASUM, false>(x, x, num_threads, mode));
+}
+
+float sasum_simd_threaded(const FloatVector& x, int num_threads, SumMode mode = SumMode::PLAIN) {
+    return static_cast<float>(reduce_threaded<ReductionKind::ASUM, true>(x, x, num_threads, mode));
+}
+
+// Referência em double (paralela; as parciais são combinadas em árvore)
+template<ReductionKind kind>
+double reduction_reference(const FloatVector& x, const FloatVector& y) {
+    size_t first_start, chunk_size;
+    thread_chunk(x.size(), NUM_THREADS, 0, first_start, chunk_size);
+    std::vector<double> partials(NUM_THREADS, 0.0);
+    for_each_thread_chunk(x.size(), NUM_THREADS, [&](size_t start, size_t end) {
+        double sum = 0.0;
+        for (size_t i = start; i < end; ++i) {
+            if constexpr (kind == ReductionKind::DOT) sum += static_cast<double>(x[i]) * y[i];
+            else if constexpr (kind == ReductionKind::NRM2) sum += static_cast<double>(x[i]) * x[i];
+            else sum += std::abs(static_cast<double>(x[i]));
+        }
+        partials[start / chunk_size] = sum;
+    });
+    PairwiseSum<double> tree;
+    for (double partial : partials) tree.add(partial);
+    return kind == ReductionKind::NRM2 ? std::sqrt(tree.total()) : tree.total();
+}
+
+#ifdef HAVE_ISPC
+// SAXPY gerado pelo ISPC (foreach)
+void saxpy_ispc(float alpha, ConstFloatSlice x, FloatSlice y) {
+    ispc::saxpy_ispc(static_cast<int>(x.size()), alpha, x.data(), y.data());
+}
+
+// SAXPY gerado pelo ISPC dividido em tarefas (launch)
+void saxpy_ispc_tasks(float alpha, ConstFloatSlice x, FloatSlice y, int num_tasks) {
+    ispc::saxpy_ispc_tasks(static_cast<int>(x.size()), alpha, x.data(), y.data(), num_tasks);
+}
+#endif
+
+// GB/s para bytes movidos em seconds
+double bandwidth_gbs(double bytes, double seconds) {
+    return bytes / BYTES_PER_GB / seconds;
+}
+
+// Bandwidth atingida em % da melhor sonda STREAM com num_threads threads
+double stream_percent(double bandwidth, int num_threads) {
+    return bandwidth / machine_roofline(num_threads).bandwidth() * 100.0;
+}
+
+// Posição de uma execução do SAXPY no roofline da máquina com num_threads threads
+RooflinePoint saxpy_roofline(size_t size, double seconds, int num_threads) {
+    return machine_roofline(num_threads).evaluate(SAXPY_FLOPS_PER_ELEMENT * size,
+                                                  SAXPY_BYTES_PER_ELEMENT * size, seconds);
 }
 
 // Executar experimento completo
-void run_saxpy_experiment() {
+void run_saxpy_experiment(HarnessCsv& timings) {
     std::cout << "=== EXPERIMENTO SAXPY (Single-precision AX + Y) ===" << std::endl;
     std::cout << "Tamanho dos vetores: " << VECTOR_SIZE << " elementos" << std::endl;
     std::cout << "Total de dados: " << (VECTOR_SIZE * sizeof(float) * 3 / (1024.0 * 1024.0 * 1024.0)) 
               << " GB" << std::endl;
     std::cout << "Número de threads: " << NUM_THREADS << std::endl;
-    std::cout << "Número de trials: " << NUM_TRIALS << std::endl;
+    std::cout << "Medição: " << harness_options.warmup_runs << " aquecimento(s), pelo menos "
+              << harness_options.min_runs << " execuções e " << harness_options.min_time << " s por versão"
+              << std::endl;
     std::cout << "Alpha: " << ALPHA << std::endl;
+    std::cout << "LLC: " << llc_size() / (1024.0 * 1024.0) << " MB, stores não temporais nas versões SIMD: "
+              << (use_streaming_stores(VECTOR_SIZE, StoreMode::AUTO) ? "sim" : "não") << std::endl;
+    std::cout << "Topologia NUMA: " << numa_topology().num_nodes() << " nó(s) ("
+              << describe_numa_topology(numa_topology()) << "), afinidade de threads: "
+              << (numa_pin_threads ? "fixa" : "livre") << std::endl;
+    std::cout << "Semente: " << data_seed << std::endl;
+    
+    // Tetos da máquina (STREAM e pico de FMA) com 1 thread e com NUM_THREADS
+    print_roofline(machine_roofline(1));
+    if (NUM_THREADS != 1) print_roofline(machine_roofline(NUM_THREADS));
     
     // Alocar memória
-    std::vector<float> x(VECTOR_SIZE);
-    std::vector<float> y(VECTOR_SIZE);
-    std::vector<float> y_ref(VECTOR_SIZE); // Para verificação
+    FloatVector x(VECTOR_SIZE);
+    FloatVector y(VECTOR_SIZE);
     
     // Gerar dados
     std::cout << "Gerando dados..." << std::endl;
-    generate_data(x, y, VECTOR_SIZE);
-    y_ref = y; // Backup para verificação
+    double setup_time = generate_data(x, y);
+    std::cout << "Dados gerados em " << setup_time << "s" << std::endl;
+    FloatVector y_expected = axpy_reference(ALPHA, x, y); // Referência para verificação
     
     BenchmarkResult results;
     
+    // Cada versão roda uma vez sobre a sua cópia de y para a verificação (o que também
+    // aquece caches e TLB) e depois é medida pelo harness; as chamadas seguintes continuam
+    // acumulando em y, o que não muda o custo
+    const size_t bytes = SAXPY_BYTES_PER_ELEMENT * VECTOR_SIZE;
+    
     // Versão serial (referência)
     std::cout << "\nExecutando SAXPY serial..." << std::endl;
-    auto y_serial = y;
-    results.serial_time = measure_time_and_bandwidth(
-        [&]() { saxpy_serial(ALPHA, x, y_serial); },
-        VECTOR_SIZE * sizeof(float) * 3,
-        results.bandwidth_serial
-    );
-    
-    // Verificar resultado serial
-    if (!verify_results(x, y_ref, y_serial, ALPHA)) {
+    auto y_serial = first_touch_copy(y, NUM_THREADS);
+    saxpy_serial(ALPHA, x, y_serial);
+    if (!check_result("serial", y_expected, y_serial)) {
         std::cout << "ERRO: Versão serial produziu resultado incorreto!" << std::endl;
         return;
     }
+    PerfRegion serial_region;
+    const TimingStats serial_stats = measure_stats(timings, "saxpy", "Serial", VECTOR_SIZE, 1, [&]() {
+        saxpy_serial(ALPHA, x, y_serial);
+    });
+    results.serial_counters = serial_region.stop(serial_stats.calls());
     
     // Versão SIMD
     std::cout << "Executando SAXPY SIMD..." << std::endl;
-    auto y_simd = y;
-    results.simd_time = measure_time_and_bandwidth(
-        [&]() { saxpy_simd(ALPHA, x, y_simd); },
-        VECTOR_SIZE * sizeof(float) * 3,
-        results.bandwidth_simd
-    );
-    
-    // Verificar resultado SIMD
-    if (!verify_results(x, y_ref, y_simd, ALPHA)) {
+    auto y_simd = first_touch_copy(y, NUM_THREADS);
+    saxpy_simd(ALPHA, x, y_simd);
+    if (!check_result("SIMD", y_expected, y_simd)) {
         std::cout << "ERRO: Versão SIMD produziu resultado incorreto!" << std::endl;
         return;
     }
+    PerfRegion simd_region;
+    const TimingStats simd_stats = measure_stats(timings, "saxpy", "SIMD", VECTOR_SIZE, 1, [&]() {
+        saxpy_simd(ALPHA, x, y_simd);
+    });
+    results.simd_counters = simd_region.stop(simd_stats.calls());
     
     // Versão multi-thread
     std::cout << "Executando SAXPY multi-thread..." << std::endl;
-    auto y_threaded = y;
-    results.threaded_time = measure_time_and_bandwidth(
-        [&]() { saxpy_threaded(ALPHA, x, y_threaded, NUM_THREADS); },
-        VECTOR_SIZE * sizeof(float) * 3,
-        results.bandwidth_threaded
-    );
-    
-    // Verificar resultado multi-thread
-    if (!verify_results(x, y_ref, y_threaded, ALPHA)) {
+    auto y_threaded = first_touch_copy(y, NUM_THREADS);
+    saxpy_threaded(ALPHA, x, y_threaded, NUM_THREADS);
+    if (!check_result("multi-thread", y_expected, y_threaded)) {
         std::cout << "ERRO: Versão multi-thread produziu resultado incorreto!" << std::endl;
         return;
     }
+    PerfRegion threaded_region(NUM_THREADS);
+    const TimingStats threaded_stats = measure_stats(timings, "saxpy", "Multi-thread", VECTOR_SIZE, NUM_THREADS, [&]() {
+        saxpy_threaded(ALPHA, x, y_threaded, NUM_THREADS);
+    });
+    results.threaded_counters = threaded_region.stop(threaded_stats.calls());
     
     // Versão SIMD + multi-thread
     std::cout << "Executando SAXPY SIMD + multi-thread..." << std::endl;
-    auto y_simd_threaded = y;
-    results.simd_threaded_time = measure_time_and_bandwidth(
-        [&]() { saxpy_simd_threaded(ALPHA, x, y_simd_threaded, NUM_THREADS); },
-        VECTOR_SIZE * sizeof(float) * 3,
-        results.bandwidth_simd_threaded
-    );
-    
-    // Verificar resultado SIMD + multi-thread
-    if (!verify_results(x, y_ref, y_simd_threaded, ALPHA)) {
+    auto y_simd_threaded = first_touch_copy(y, NUM_THREADS);
+    saxpy_simd_threaded(ALPHA, x, y_simd_threaded, NUM_THREADS);
+    if (!check_result("SIMD + multi-thread", y_expected, y_simd_threaded)) {
         std::cout << "ERRO: Versão SIMD+multi-thread produziu resultado incorreto!" << std::endl;
         return;
     }
+    PerfRegion simd_threaded_region(NUM_THREADS);
+    const TimingStats simd_threaded_stats =
+        measure_stats(timings, "saxpy", "SIMD+Multi-thread", VECTOR_SIZE, NUM_THREADS, [&]() {
+            saxpy_simd_threaded(ALPHA, x, y_simd_threaded, NUM_THREADS);
+        });
+    results.simd_threaded_counters = simd_threaded_region.stop(simd_threaded_stats.calls());
+    
+    results.serial_time = serial_stats.median;
+    results.simd_time = simd_stats.median;
+    results.threaded_time = threaded_stats.median;
+    results.simd_threaded_time = simd_threaded_stats.median;
+    results.bandwidth_serial = bandwidth_gbs(bytes, results.serial_time);
+    results.bandwidth_simd = bandwidth_gbs(bytes, results.simd_time);
+    results.bandwidth_threaded = bandwidth_gbs(bytes, results.threaded_time);
+    results.bandwidth_simd_threaded = bandwidth_gbs(bytes, results.simd_threaded_time);
     
-    // Calcular speedups e eficiências
+#ifdef HAVE_ISPC
+    // Versões geradas pelo ISPC
+    std::cout << "Executando SAXPY ISPC..." << std::endl;
+    auto y_ispc = first_touch_copy(y, NUM_THREADS);
+    saxpy_ispc(ALPHA, x, y_ispc);
+    if (!check_result("ISPC", y_expected, y_ispc, ISPC_TOLERANCE)) {
+        std::cout << "ERRO: Versão ISPC produziu resultado incorreto!" << std::endl;
+        return;
+    }
+    PerfRegion ispc_region;
+    const TimingStats ispc_stats = measure_stats(timings, "saxpy", "ISPC", VECTOR_SIZE, 1, [&]() {
+        saxpy_ispc(ALPHA, x, y_ispc);
+    });
+    results.ispc_counters = ispc_region.stop(ispc_stats.calls());
+    
+    std::cout << "Executando SAXPY ISPC + tasks..." << std::endl;
+    auto y_ispc_tasks = first_touch_copy(y, NUM_THREADS);
+    saxpy_ispc_tasks(ALPHA, x, y_ispc_tasks, NUM_THREADS);
+    if (!check_result("ISPC + tasks", y_expected, y_ispc_tasks, ISPC_TOLERANCE)) {
+        std::cout << "ERRO: Versão ISPC + tasks produziu resultado incorreto!" << std::endl;
+        return;
+    }
+    const TimingStats ispc_tasks_stats = measure_stats(timings, "saxpy", "ISPC+tasks", VECTOR_SIZE, NUM_THREADS, [&]() {
+        saxpy_ispc_tasks(ALPHA, x, y_ispc_tasks, NUM_THREADS);
+    });
+    
+    results.ispc_time = ispc_stats.median;
+    results.ispc_tasks_time = ispc_tasks_stats.median;
+    results.bandwidth_ispc = bandwidth_gbs(bytes, results.ispc_time);
+    results.bandwidth_ispc_tasks = bandwidth_gbs(bytes, results.ispc_tasks_time);
+#endif
+    
+    // Calcular speedups
     results.speedup_simd = results.serial_time / results.simd_time;
     results.speedup_threaded = results.serial_time / results.threaded_time;
     results.speedup_simd_threaded = results.serial_time / results.simd_threaded_time;
     
-    results.efficiency_simd = (results.speedup_simd / 8.0) * 100.0; // AVX2 tem 8 lanes
-    results.efficiency_threaded = (results.speedup_threaded / NUM_THREADS) * 100.0;
-    
     // Exibir resultados
     std::cout << "\n" << std::string(70, '=') << std::endl;
     std::cout << "RESULTADOS DO EXPERIMENTO SAXPY" << std::endl;
     std::cout << std::string(70, '=') << std::endl;
     
+    // O SAXPY é limitado por memória: a referência é a bandwidth STREAM, não o número de lanes
     std::cout << "Serial:      " << results.serial_time << "s, " 
-              << results.bandwidth_serial << " GB/s" << std::endl;
+              << results.bandwidth_serial << " GB/s ("
+              << stream_percent(results.bandwidth_serial, 1) << "% do STREAM)" << std::endl;
     
     std::cout << "SIMD:        " << results.simd_time << "s, " 
-              << results.bandwidth_simd << " GB/s, "
-              << "Speedup: " << results.speedup_simd << "x, "
-              << "Eficiência: " << results.efficiency_simd << "%" << std::endl;
+              << results.bandwidth_simd << " GB/s ("
+              << stream_percent(results.bandwidth_simd, 1) << "% do STREAM), "
+              << "Speedup: " << results.speedup_simd << "x" << std::endl;
     
     std::cout << "Multi-thread:" << results.threaded_time << "s, " 
-              << results.bandwidth_threaded << " GB/s, "
-              << "Speedup: " << results.speedup_threaded << "x, "
-              << "Eficiência: " << results.efficiency_threaded << "%" << std::endl;
+              << results.bandwidth_threaded << " GB/s ("
+              << stream_percent(results.bandwidth_threaded, NUM_THREADS) << "% do STREAM), "
+              << "Speedup: " << results.speedup_threaded << "x" << std::endl;
     
     std::cout << "SIMD+Thread: " << results.simd_threaded_time << "s, " 
-              << results.bandwidth_simd_threaded << " GB/s, "
+              << results.bandwidth_simd_threaded << " GB/s ("
+              << stream_percent(results.bandwidth_simd_threaded, NUM_THREADS) << "% do STREAM), "
               << "Speedup: " << results.speedup_simd_threaded << "x" << std::endl;
     
+#ifdef HAVE_ISPC
+    std::cout << "ISPC:        " << results.ispc_time << "s, "
+              << results.bandwidth_ispc << " GB/s ("
+              << stream_percent(results.bandwidth_ispc, 1) << "% do STREAM), "
+              << "Speedup: " << results.serial_time / results.ispc_time << "x" << std::endl;
+    
+    std::cout << "ISPC+tasks:  " << results.ispc_tasks_time << "s, "
+              << results.bandwidth_ispc_tasks << " GB/s ("
+              << stream_percent(results.bandwidth_ispc_tasks, NUM_THREADS) << "% do STREAM), "
+              << "Speedup: " << results.serial_time / results.ispc_tasks_time << "x" << std::endl;
+#endif
+    
+    std::cout << "\nESTATÍSTICAS DAS MEDIÇÕES (tempos acima = mediana):" << std::endl;
+    print_timing_stats("Serial", serial_stats);
+    print_timing_stats("SIMD", simd_stats);
+    print_timing_stats("Multi-thread", threaded_stats);
+    print_timing_stats("SIMD+Thread", simd_threaded_stats);
+#ifdef HAVE_ISPC
+    print_timing_stats("ISPC", ispc_stats);
+    print_timing_stats("ISPC+tasks", ispc_tasks_stats);
+#endif
+    
     std::cout << "\nANÁLISE DE BANDWIDTH:" << std::endl;
     std::cout << "Aumento de bandwidth SIMD: " << (results.bandwidth_simd / results.bandwidth_serial) << "x" << std::endl;
     std::cout << "Aumento de bandwidth Multi-thread: " << (results.bandwidth_threaded / results.bandwidth_serial) << "x" << std::endl;
@@ -307,117 +770,516 @@ void run_saxpy_experiment() {
     
     // Salvar resultados em CSV
     std::ofstream csv_file("saxpy_results.csv");
-    csv_file << "Implementação,Tempo(s),Bandwidth(GB/s),Speedup,Eficiência(%)\n";
-    csv_file << "Serial," << results.serial_time << "," << results.bandwidth_serial << ",1.0,100.0\n";
+    const std::string numa = numa_csv_columns();
+    const RooflinePoint serial_point = saxpy_roofline(VECTOR_SIZE, results.serial_time, 1);
+    const RooflinePoint simd_point = saxpy_roofline(VECTOR_SIZE, results.simd_time, 1);
+    const RooflinePoint threaded_point = saxpy_roofline(VECTOR_SIZE, results.threaded_time, NUM_THREADS);
+    const RooflinePoint simd_threaded_point = saxpy_roofline(VECTOR_SIZE, results.simd_threaded_time, NUM_THREADS);
+    csv_file << "Implementação,Tempo(s),Bandwidth(GB/s),Speedup,STREAM(%)" << ROOFLINE_CSV_HEADER
+             << perf_csv_header() << NUMA_CSV_HEADER << "\n";
+    csv_file << "Serial," << results.serial_time << "," << results.bandwidth_serial << ",1.0,"
+             << stream_percent(results.bandwidth_serial, 1)
+             << roofline_csv_columns(serial_point) << perf_csv_columns(results.serial_counters) << numa << "\n";
     csv_file << "SIMD," << results.simd_time << "," << results.bandwidth_simd << "," 
-             << results.speedup_simd << "," << results.efficiency_simd << "\n";
+             << results.speedup_simd << "," << stream_percent(results.bandwidth_simd, 1)
+             << roofline_csv_columns(simd_point) << perf_csv_columns(results.simd_counters) << numa << "\n";
     csv_file << "Multi-thread," << results.threaded_time << "," << results.bandwidth_threaded << "," 
-             << results.speedup_threaded << "," << results.efficiency_threaded << "\n";
+             << results.speedup_threaded << "," << stream_percent(results.bandwidth_threaded, NUM_THREADS)
+             << roofline_csv_columns(threaded_point) << perf_csv_columns(results.threaded_counters) << numa << "\n";
     csv_file << "SIMD+Multi-thread," << results.simd_threaded_time << "," << results.bandwidth_simd_threaded << "," 
-             << results.speedup_simd_threaded << ",-\n";
+             << results.speedup_simd_threaded << "," << stream_percent(results.bandwidth_simd_threaded, NUM_THREADS)
+             << roofline_csv_columns(simd_threaded_point)
+             << perf_csv_columns(results.simd_threaded_counters) << numa << "\n";
+#ifdef HAVE_ISPC
+    const RooflinePoint ispc_point = saxpy_roofline(VECTOR_SIZE, results.ispc_time, 1);
+    const RooflinePoint ispc_tasks_point = saxpy_roofline(VECTOR_SIZE, results.ispc_tasks_time, NUM_THREADS);
+    csv_file << "ISPC," << results.ispc_time << "," << results.bandwidth_ispc << ","
+             << results.serial_time / results.ispc_time << "," << stream_percent(results.bandwidth_ispc, 1)
+             << roofline_csv_columns(ispc_point) << perf_csv_columns(results.ispc_counters) << numa << "\n";
+    csv_file << "ISPC+tasks," << results.ispc_tasks_time << "," << results.bandwidth_ispc_tasks << ","
+             << results.serial_time / results.ispc_tasks_time << ","
+             << stream_percent(results.bandwidth_ispc_tasks, NUM_THREADS) << roofline_csv_columns(ispc_tasks_point)
+             << perf_csv_columns(results.ispc_tasks_counters) << numa << "\n";
+#endif
     
     csv_file.close();
     std::cout << "\nResultados salvos em saxpy_results.csv" << std::endl;
     
-    // Análise de escalabilidade
-    std::cout << "\nANÁLISE DE ESCALABILIDADE:" << std::endl;
-    std::cout << "Speedup teórico máximo SIMD (AVX2): 8x" << std::endl;
-    std::cout << "Speedup teórico máximo Threading: " << NUM_THREADS << "x" << std::endl;
-    std::cout << "Speedup teórico máximo combinado: " << (8 * NUM_THREADS) << "x" << std::endl;
+    // Análise roofline: com 1/6 FLOP por byte o SAXPY é limitado pela memória, então o
+    // teto é a bandwidth do STREAM e não 8 lanes x NUM_THREADS
+    std::cout << "\nANÁLISE ROOFLINE (teto = min(pico de FMA, intensidade x bandwidth do STREAM)):" << std::endl;
+    print_roofline_point("Serial", serial_point);
+    print_roofline_point("SIMD", simd_point);
+    print_roofline_point("Multi-thread", threaded_point);
+    print_roofline_point("SIMD+Thread", simd_threaded_point);
+#ifdef HAVE_ISPC
+    print_roofline_point("ISPC", ispc_point);
+    print_roofline_point("ISPC+tasks", ispc_tasks_point);
+#endif
+    print_perf_sample("Contadores serial", results.serial_counters);
+    print_perf_sample("Contadores SIMD", results.simd_counters);
+    print_perf_sample("Contadores multi-thread", results.threaded_counters);
+    print_perf_sample("Contadores SIMD+Thread", results.simd_threaded_counters);
+#ifdef HAVE_ISPC
+    print_perf_sample("Contadores ISPC", results.ispc_counters);
+#endif
+    std::cout << "Speedup máximo SIMD+Thread pelo roofline: "
+              << simd_threaded_point.attainable / serial_point.gflops << "x (alcançado "
+              << results.speedup_simd_threaded << "x)" << std::endl;
+}
+
+// Varredura de working set (de 4 KiB até alguns GiB) de todas as versões do SAXPY. x e y
+// são alocados e gerados uma vez no maior tamanho; cada ponto usa os primeiros n elementos.
+void run_sweep_experiment(HarnessCsv& timings) {
+    std::cout << "\n" << std::string(70, '=') << std::endl;
+    std::cout << "VARREDURA DE WORKING SET (x + y)" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
     
-    std::cout << "Speedup alcançado SIMD: " << results.speedup_simd << "x (" 
-              << (results.speedup_simd / 8.0 * 100.0) << "% do teórico)" << std::endl;
+    double dispatch_pool, dispatch_spawn;
+    measure_dispatch_overhead(NUM_THREADS, DISPATCH_CALLS, dispatch_pool, dispatch_spawn);
+    std::cout << "Custo de despacho (parallel_for vazio): pool " << dispatch_pool * 1e6
+              << " us, threads por chamada " << dispatch_spawn * 1e6 << " us" << std::endl;
     
-    std::cout << "Speedup alcançado Threading: " << results.speedup_threaded << "x (" 
-              << (results.speedup_threaded / NUM_THREADS * 100.0) << "% do teórico)" << std::endl;
+    const size_t max_elements = sweep_limit_bytes() / (2 * sizeof(float));
+    FloatVector x(max_elements);
+    FloatVector y(max_elements);
+    std::cout << "Dados gerados em " << generate_data(x, y) << "s" << std::endl;
+    const ConstFloatSlice xs = x;
+    const FloatSlice ys = y;
     
-    std::cout << "Speedup alcançado combinado: " << results.speedup_simd_threaded << "x (" 
-              << (results.speedup_simd_threaded / (8.0 * NUM_THREADS) * 100.0) << "% do teórico)" << std::endl;
+    const std::vector<SweepVariant> variants = {
+        {"Serial", 1, [&](size_t n) { saxpy_serial(ALPHA, xs.first(n), ys.first(n)); }},
+        {"SIMD", 1, [&](size_t n) { saxpy_simd(ALPHA, xs.first(n), ys.first(n), StoreMode::REGULAR); }},
+        {"Multi-thread", NUM_THREADS, [&](size_t n) { saxpy_threaded(ALPHA, xs.first(n), ys.first(n), NUM_THREADS); }},
+        {"SIMD+Multi-thread", NUM_THREADS,
+         [&](size_t n) { saxpy_simd_threaded(ALPHA, xs.first(n), ys.first(n), NUM_THREADS, StoreMode::REGULAR); }},
+        {"SIMD (stream)", 1, [&](size_t n) { saxpy_simd(ALPHA, xs.first(n), ys.first(n), StoreMode::STREAMING); }},
+        {"SIMD+Multi-thread (stream)", NUM_THREADS,
+         [&](size_t n) { saxpy_simd_threaded(ALPHA, xs.first(n), ys.first(n), NUM_THREADS, StoreMode::STREAMING); }},
+        {"SIMD+Multi-thread (spawn)", NUM_THREADS,
+         [&](size_t n) { saxpy_simd_threaded_spawn(ALPHA, xs.first(n), ys.first(n), NUM_THREADS); }},
+#ifdef HAVE_ISPC
+        {"ISPC", 1, [&](size_t n) { saxpy_ispc(ALPHA, xs.first(n), ys.first(n)); }},
+        {"ISPC+tasks", NUM_THREADS, [&](size_t n) { saxpy_ispc_tasks(ALPHA, xs.first(n), ys.first(n), NUM_THREADS); }},
+#endif
+    };
+    const std::vector<SweepCrossover> crossovers = {
+        {"Serial", "Multi-thread"},
+        {"SIMD", "SIMD+Multi-thread"},
+        {"SIMD (stream)", "SIMD+Multi-thread (stream)"},
+    };
+    run_working_set_sweep("saxpy", variants, crossovers,
+                          {2 * sizeof(float), SAXPY_BYTES_PER_ELEMENT, SAXPY_FLOPS_PER_ELEMENT}, max_elements,
+                          timings);
 }
 
-// Teste de escalabilidade com diferentes tamanhos de vetor
-void run_scalability_test() {
+// Cadeia y = alpha * x + y; z = beta * y + z; ||z||: chamadas separadas (uma passada pela
+// memória cada) contra uma única passada fundida por blas1::fuse
+void run_fused_experiment(HarnessCsv& timings) {
     std::cout << "\n" << std::string(70, '=') << std::endl;
-    std::cout << "TESTE DE ESCALABILIDADE COM DIFERENTES TAMANHOS" << std::endl;
+    std::cout << "CADEIA BLAS-1 FUNDIDA: y = a*x + y; z = b*y + z; ||z||" << std::endl;
     std::cout << std::string(70, '=') << std::endl;
     
-    std::vector<size_t> sizes = {
-        1000000,    // 1M
-        10000000,   // 10M
-        50000000,   // 50M
-        100000000,  // 100M
-        200000000   // 200M
+    FloatVector x(VECTOR_SIZE);
+    FloatVector y(VECTOR_SIZE);
+    FloatVector z(VECTOR_SIZE);
+    generate_data(x, y);
+    fill_uniform(z, -DATA_RANGE, DATA_RANGE, data_seed, 2, NUM_THREADS);
+    
+    auto y_separate = first_touch_copy(y, NUM_THREADS);
+    auto z_separate = first_touch_copy(z, NUM_THREADS);
+    auto y_fused = first_touch_copy(y, NUM_THREADS);
+    auto z_fused = first_touch_copy(z, NUM_THREADS);
+    
+    using blas1::assign;
+    using blas1::fuse;
+    using blas1::sum_squares;
+    const blas1::Vector xv = blas1::vec(x);
+    const blas1::Vector ys = blas1::vec(y_separate), zs = blas1::vec(z_separate);
+    const blas1::Vector yf = blas1::vec(y_fused), zf = blas1::vec(z_fused);
+    
+    // Chamadas separadas: SAXPY, SAXPY e a norma, cada uma percorrendo os vetores inteiros
+    const size_t separate_bytes = fuse(assign(ys, ALPHA * xv + ys)).traffic_bytes(VECTOR_SIZE) +
+                                  fuse(assign(zs, BETA * ys + zs)).traffic_bytes(VECTOR_SIZE) +
+                                  fuse().traffic_bytes(VECTOR_SIZE, sum_squares(zs));
+    auto run_separate = [&]() {
+        saxpy_simd_threaded(ALPHA, x, y_separate, NUM_THREADS);
+        saxpy_simd_threaded(BETA, y_separate, z_separate, NUM_THREADS);
+        return std::sqrt(fuse().run_reduce(sum_squares(zs), VECTOR_SIZE, NUM_THREADS));
     };
     
-    std::ofstream scalability_file("saxpy_scalability.csv");
-    scalability_file << "Tamanho,SerialTime,SIMDTime,ThreadedTime,SIMDThreadedTime,"
-                     << "SerialBW,SIMDBW,ThreadedBW,SIMDThreadedBW\n";
+    // Uma passada: y e z de cada pedaço ainda estão na L1 para a etapa seguinte e a norma
+    auto chain = fuse(assign(yf, ALPHA * xv + yf), assign(zf, BETA * yf + zf));
+    const size_t fused_bytes = chain.traffic_bytes(VECTOR_SIZE, sum_squares(zf));
+    auto run_fused = [&]() { return std::sqrt(chain.run_reduce(sum_squares(zf), VECTOR_SIZE, NUM_THREADS)); };
     
-    for (size_t size : sizes) {
-        std::cout << "\nTestando tamanho: " << size << " elementos (" 
-                  << (size * sizeof(float) * 3 / (1024.0 * 1024.0 * 1024.0)) << " GB)" << std::endl;
-        
-        std::vector<float> x(size);
-        std::vector<float> y(size);
-        generate_data(x, y, size);
-        
-        double time_serial, bw_serial;
-        double time_simd, bw_simd;
-        double time_threaded, bw_threaded;
-        double time_simd_threaded, bw_simd_threaded;
-        
-        // Serial
-        auto y_serial = y;
-        time_serial = measure_time_and_bandwidth(
-            [&]() { saxpy_serial(ALPHA, x, y_serial); },
-            size * sizeof(float) * 3,
-            bw_serial
-        );
-        
-        // SIMD
-        auto y_simd = y;
-        time_simd = measure_time_and_bandwidth(
-            [&]() { saxpy_simd(ALPHA, x, y_simd); },
-            size * sizeof(float) * 3,
-            bw_simd
-        );
-        
-        // Multi-thread
-        auto y_threaded = y;
-        time_threaded = measure_time_and_bandwidth(
-            [&]() { saxpy_threaded(ALPHA, x, y_threaded, NUM_THREADS); },
-            size * sizeof(float) * 3,
-            bw_threaded
-        );
-        
-        // SIMD + Multi-thread
-        auto y_simd_threaded = y;
-        time_simd_threaded = measure_time_and_bandwidth(
-            [&]() { saxpy_simd_threaded(ALPHA, x, y_simd_threaded, NUM_THREADS); },
-            size * sizeof(float) * 3,
-            bw_simd_threaded
-        );
+    // A primeira chamada de cada versão é a verificada; as do harness seguem acumulando em y e z
+    const double separate_norm = run_separate();
+    const double fused_norm = run_fused();
+    print_verification("Verificação z fundido", verify_buffers(z_separate, z_fused, 0, 0.0f, NUM_THREADS));
+    
+    PerfRegion separate_region(NUM_THREADS);
+    const TimingStats separate_stats =
+        measure_stats(timings, "fusão", "Separadas", VECTOR_SIZE, NUM_THREADS, run_separate);
+    const PerfSample separate_counters = separate_region.stop(separate_stats.calls());
+    PerfRegion fused_region(NUM_THREADS);
+    const TimingStats fused_stats = measure_stats(timings, "fusão", "Fundida", VECTOR_SIZE, NUM_THREADS, run_fused);
+    const PerfSample fused_counters = fused_region.stop(fused_stats.calls());
+    const double separate_time = separate_stats.median, fused_time = fused_stats.median;
+    const double separate_bw = bandwidth_gbs(separate_bytes, separate_time);
+    const double fused_bw = bandwidth_gbs(fused_bytes, fused_time);
+    
+    const double gib = 1024.0 * 1024.0 * 1024.0;
+    std::cout << "Separadas: " << separate_time << "s, " << separate_bytes / gib << " GB movidos, "
+              << separate_bw << " GB/s, ||z|| = " << separate_norm << std::endl;
+    std::cout << "Fundida:   " << fused_time << "s, " << fused_bytes / gib << " GB movidos, "
+              << fused_bw << " GB/s, ||z|| = " << fused_norm << std::endl;
+    std::cout << "Ganho da fusão: " << separate_time / fused_time << "x (tráfego "
+              << static_cast<double>(separate_bytes) / fused_bytes << "x menor)" << std::endl;
+    print_timing_stats("Separadas", separate_stats);
+    print_timing_stats("Fundida", fused_stats);
+    
+    // Mesmas contas nas duas versões: duas FMAs e o quadrado somado da norma por elemento
+    const double chain_flops = 6.0 * VECTOR_SIZE;
+    const RooflinePoint separate_point =
+        machine_roofline(NUM_THREADS).evaluate(chain_flops, separate_bytes, separate_time);
+    const RooflinePoint fused_point = machine_roofline(NUM_THREADS).evaluate(chain_flops, fused_bytes, fused_time);
+    print_roofline_point("Separadas", separate_point);
+    print_roofline_point("Fundida", fused_point);
+    print_perf_sample("Contadores separadas", separate_counters);
+    print_perf_sample("Contadores fundida", fused_counters);
+    
+    std::ofstream fused_file("saxpy_fused.csv");
+    fused_file << "Versão,Bytes,Tempo(s),Bandwidth(GB/s),Norma" << ROOFLINE_CSV_HEADER << perf_csv_header()
+               << NUMA_CSV_HEADER << "\n";
+    fused_file << "Separadas," << separate_bytes << "," << separate_time << "," << separate_bw << ","
+               << separate_norm << roofline_csv_columns(separate_point) << perf_csv_columns(separate_counters)
+               << numa_csv_columns() << "\n";
+    fused_file << "Fundida," << fused_bytes << "," << fused_time << "," << fused_bw << ","
+               << fused_norm << roofline_csv_columns(fused_point) << perf_csv_columns(fused_counters)
+               << numa_csv_columns() << "\n";
+    std::cout << "Resultados salvos em saxpy_fused.csv" << std::endl;
+}
+
+// Armazenamento de x e y: fp32 ou um dos formatos de 16 bits
+struct PrecisionResult {
+    const char* storage;
+    size_t bytes_per_element;  // De cada vetor
+    TimingStats stats;
+    VerifyResult verification;
+    PerfSample counters;
+};
+
+// Maior erro absoluto esperado com x e y guardados num formato de epsilon dado: meio
+// epsilon relativo no arredondamento de x, de y e do resultado, com |x|, |y| <= DATA_RANGE
+float reduced_tolerance(float epsilon) {
+    return epsilon * (std::abs(ALPHA) + 1.0f) * DATA_RANGE;
+}
+
+// SAXPY SIMD + multi-thread com x e y convertidos para Storage. A primeira chamada é
+// comparada (em float, via decoded) com a referência fp32. O erro em ULPs de float não
+// tem sentido aqui (perto de alpha * x ~ -y o sinal pode até trocar) e não é mostrado;
+// valem o erro absoluto e o relativo médio. As chamadas do harness seguem acumulando em
+// y, que no fp16 pode saturar em +-inf sem mudar o custo.
+template<typename Storage>
+PrecisionResult run_reduced_storage(HarnessCsv& timings, const FloatVector& x, const FloatVector& y,
+                                    const FloatVector& expected, FloatVector& decoded) {
+    using StorageVector = std::vector<Storage, AlignedAllocator<Storage>>;
+    StorageVector x_reduced(x.size());
+    StorageVector y_reduced(y.size());
+    narrow_floats<Storage>(x, x_reduced, NUM_THREADS);
+    narrow_floats<Storage>(y, y_reduced, NUM_THREADS);
+    
+    std::cout << "Executando SAXPY SIMD + multi-thread em " << Storage::name << "..." << std::endl;
+    PrecisionResult result{Storage::name, sizeof(Storage), {}, {}, {}};
+    saxpy_simd_threaded_reduced<Storage>(ALPHA, x_reduced, y_reduced, NUM_THREADS);
+    widen_floats<Storage>(y_reduced, decoded, NUM_THREADS);
+    result.verification =
+        verify_buffers(expected, decoded, SAXPY_MAX_ULPS, reduced_tolerance(Storage::epsilon), NUM_THREADS);
+    std::cout << "  Verificação " << Storage::name << ": erro absoluto máx " << result.verification.max_abs_error
+              << " (tolerância " << reduced_tolerance(Storage::epsilon) << "), erro relativo médio "
+              << result.verification.mean_relative_error << ", " << result.verification.mismatches
+              << " divergências de " << result.verification.count << std::endl;
+    
+    PerfRegion region(NUM_THREADS);
+    result.stats = measure_stats(timings, "precisão", Storage::name, VECTOR_SIZE, NUM_THREADS, [&]() {
+        saxpy_simd_threaded_reduced<Storage>(ALPHA, x_reduced, y_reduced, NUM_THREADS);
+    });
+    result.counters = region.stop(result.stats.calls());
+    return result;
+}
+
+// SAXPY SIMD + multi-thread com x e y em fp32, fp16 e bf16 (contas sempre em fp32):
+// elementos por segundo e erro de cada formato em relação à referência fp32
+void run_precision_experiment(HarnessCsv& timings) {
+    std::cout << "\n" << std::string(70, '=') << std::endl;
+    std::cout << "ARMAZENAMENTO EM PRECISÃO REDUZIDA (fp16/bf16 na memória, contas em fp32)" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    
+    FloatVector x(VECTOR_SIZE);
+    FloatVector y(VECTOR_SIZE);
+    generate_data(x, y);
+    const FloatVector y_expected = axpy_reference(ALPHA, x, y);
+    
+    std::vector<PrecisionResult> results;
+    
+    // fp32: o mesmo kernel do experimento principal, com stores regulares como os de 16 bits
+    std::cout << "Executando SAXPY SIMD + multi-thread em fp32..." << std::endl;
+    auto y_fp32 = first_touch_copy(y, NUM_THREADS);
+    PrecisionResult fp32{"fp32", sizeof(float), {}, {}, {}};
+    saxpy_simd_threaded(ALPHA, x, y_fp32, NUM_THREADS, StoreMode::REGULAR);
+    fp32.verification = verify_buffers(y_expected, y_fp32, SAXPY_MAX_ULPS, 0.0f, NUM_THREADS);
+    print_verification("  Verificação fp32", fp32.verification);
+    PerfRegion fp32_region(NUM_THREADS);
+    fp32.stats = measure_stats(timings, "precisão", "fp32", VECTOR_SIZE, NUM_THREADS, [&]() {
+        saxpy_simd_threaded(ALPHA, x, y_fp32, NUM_THREADS, StoreMode::REGULAR);
+    });
+    fp32.counters = fp32_region.stop(fp32.stats.calls());
+    results.push_back(fp32);
+    
+    // y_fp32 já foi usado; serve de buffer para os resultados de 16 bits convertidos
+    results.push_back(run_reduced_storage<Float16>(timings, x, y, y_expected, y_fp32));
+    results.push_back(run_reduced_storage<BFloat16>(timings, x, y, y_expected, y_fp32));
+    
+    std::ofstream csv_file("saxpy_precision.csv");
+    csv_file << "Armazenamento,BytesPorElemento,Tempo(s),Elementos/s,Bandwidth(GB/s),Speedup,ErroAbsolutoMáx,"
+                "ErroRelativoMédio,Divergências"
+             << ROOFLINE_CSV_HEADER << perf_csv_header() << NUMA_CSV_HEADER << "\n";
+    
+    std::cout << "\nElementos por segundo (x e y lidos, y escrito), speedup sobre fp32:" << std::endl;
+    for (const PrecisionResult& result : results) {
+        const double seconds = result.stats.median;
+        const double elements_per_second = VECTOR_SIZE / seconds;
+        const double bytes = 3.0 * result.bytes_per_element * VECTOR_SIZE;
+        const double speedup = fp32.stats.median / seconds;
+        const RooflinePoint point =
+            machine_roofline(NUM_THREADS).evaluate(SAXPY_FLOPS_PER_ELEMENT * VECTOR_SIZE, bytes, seconds);
         
-        scalability_file << size << ","
-                         << time_serial << "," << time_simd << "," << time_threaded << "," << time_simd_threaded << ","
-                         << bw_serial << "," << bw_simd << "," << bw_threaded << "," << bw_simd_threaded << "\n";
+        std::cout << result.storage << ": " << seconds << "s, " << elements_per_second / 1e9 << " Gelem/s, "
+                  << bandwidth_gbs(bytes, seconds) << " GB/s, speedup " << speedup << "x, erro absoluto máx "
+                  << result.verification.max_abs_error << ", erro relativo médio "
+                  << result.verification.mean_relative_error << std::endl;
+        print_timing_stats(std::string("  ") + result.storage, result.stats);
+        print_perf_sample(std::string("  Contadores ") + result.storage, result.counters);
         
-        std::cout << "  Serial: " << time_serial << "s, " << bw_serial << " GB/s" << std::endl;
-        std::cout << "  SIMD: " << time_simd << "s, " << bw_simd << " GB/s" << std::endl;
-        std::cout << "  Threaded: " << time_threaded << "s, " << bw_threaded << " GB/s" << std::endl;
-        std::cout << "  SIMD+Threaded: " << time_simd_threaded << "s, " << bw_simd_threaded << " GB/s" << std::endl;
+        csv_file << result.storage << "," << result.bytes_per_element << "," << seconds << ","
+                 << elements_per_second << "," << bandwidth_gbs(bytes, seconds) << "," << speedup << ","
+                 << result.verification.max_abs_error << ","
+                 << result.verification.mean_relative_error << ","
+                 << result.verification.mismatches << roofline_csv_columns(point) << perf_csv_columns(result.counters)
+                 << numa_csv_columns() << "\n";
     }
+    std::cout << "Resultados salvos em saxpy_precision.csv" << std::endl;
+}
+
+// sdot, snrm2 e sasum em todas as variantes e modos de soma, comparados com a referência
+// em double: tempo (mediana do harness), bandwidth e erro relativo
+void run_reduction_experiment(HarnessCsv& timings) {
+    std::cout << "\n" << std::string(70, '=') << std::endl;
+    std::cout << "REDUÇÕES BLAS-1: sdot, snrm2, sasum" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    
+    FloatVector x(VECTOR_SIZE);
+    FloatVector y(VECTOR_SIZE);
+    generate_data(x, y);
+    
+    struct Variant {
+        const char* kernel;
+        const char* variant;
+        size_t bytes;
+        double flops;  // Da operação (1 FMA ou 1 soma por elemento), sem as contas extras de Kahan
+        int threads;  // Workers do pool; 0 nas versões que rodam só na thread principal
+        double reference;
+        std::function<float(SumMode)> run;
+    };
+    
+    const size_t one = VECTOR_SIZE * sizeof(float);
+    const double dot_reference = reduction_reference<ReductionKind::DOT>(x, y);
+    const double nrm2_reference = reduction_reference<ReductionKind::NRM2>(x, x);
+    const double asum_reference = reduction_reference<ReductionKind::ASUM>(x, x);
+    const std::vector<Variant> variants = {
+        {"sdot", "Serial", 2 * one, 2.0 * VECTOR_SIZE, 0, dot_reference,
+         [&](SumMode mode) { return sdot_serial(x, y, mode); }},
+        {"sdot", "SIMD", 2 * one, 2.0 * VECTOR_SIZE, 0, dot_reference,
+         [&](SumMode mode) { return sdot_simd(x, y, mode); }},
+        {"sdot", "Multi-thread", 2 * one, 2.0 * VECTOR_SIZE, NUM_THREADS, dot_reference,
+         [&](SumMode mode) { return sdot_threaded(x, y, NUM_THREADS, mode); }},
+        {"sdot", "SIMD+Multi-thread", 2 * one, 2.0 * VECTOR_SIZE, NUM_THREADS, dot_reference,
+         [&](SumMode mode) { return sdot_simd_threaded(x, y, NUM_THREADS, mode); }},
+        {"snrm2", "Serial", one, 2.0 * VECTOR_SIZE, 0, nrm2_reference,
+         [&](SumMode mode) { return snrm2_serial(x, mode); }},
+        {"snrm2", "SIMD", one, 2.0 * VECTOR_SIZE, 0, nrm2_reference,
+         [&](SumMode mode) { return snrm2_simd(x, mode); }},
+        {"snrm2", "Multi-thread", one, 2.0 * VECTOR_SIZE, NUM_THREADS, nrm2_reference,
+         [&](SumMode mode) { return snrm2_threaded(x, NUM_THREADS, mode); }},
+        {"snrm2", "SIMD+Multi-thread", one, 2.0 * VECTOR_SIZE, NUM_THREADS, nrm2_reference,
+         [&](SumMode mode) { return snrm2_simd_threaded(x, NUM_THREADS, mode); }},
+        {"sasum", "Serial", one, 1.0 * VECTOR_SIZE, 0, asum_reference,
+         [&](SumMode mode) { return sasum_serial(x, mode); }},
+        {"sasum", "SIMD", one, 1.0 * VECTOR_SIZE, 0, asum_reference,
+         [&](SumMode mode) { return sasum_simd(x, mode); }},
+        {"sasum", "Multi-thread", one, 1.0 * VECTOR_SIZE, NUM_THREADS, asum_reference,
+         [&](SumMode mode) { return sasum_threaded(x, NUM_THREADS, mode); }},
+        {"sasum", "SIMD+Multi-thread", one, 1.0 * VECTOR_SIZE, NUM_THREADS, asum_reference,
+         [&](SumMode mode) { return sasum_simd_threaded(x, NUM_THREADS, mode); }},
+    };
+    
+    std::ofstream csv_file("saxpy_reductions.csv");
+    csv_file << "Kernel,Variante,Modo,Tempo(s),Bandwidth(GB/s),Resultado,Referência,ErroRelativo"
+             << ROOFLINE_CSV_HEADER << perf_csv_header() << NUMA_CSV_HEADER << "\n";
     
-    scalability_file.close();
-    std::cout << "\nDados de escalabilidade salvos em saxpy_scalability.csv" << std::endl;
+    for (const Variant& variant : variants) {
+        for (SumMode mode : {SumMode::PLAIN, SumMode::KAHAN, SumMode::PAIRWISE}) {
+            float result = 0.0f;
+            PerfRegion region(variant.threads);
+            const TimingStats stats =
+                measure_stats(timings, std::string("redução ") + sum_mode_name(mode),
+                              std::string(variant.kernel) + " " + variant.variant, VECTOR_SIZE,
+                              std::max(1, variant.threads), [&]() { result = variant.run(mode); });
+            const PerfSample counters = region.stop(stats.calls());
+            const double median_time = stats.median;
+            const double bandwidth = bandwidth_gbs(variant.bytes, median_time);
+            const double relative_error = std::abs(result - variant.reference) / std::abs(variant.reference);
+            const RooflinePoint point =
+                machine_roofline(std::max(1, variant.threads)).evaluate(variant.flops, variant.bytes, median_time);
+            
+            std::cout << variant.kernel << " " << variant.variant << " (" << sum_mode_name(mode) << "): "
+                      << median_time << "s, " << bandwidth << " GB/s (" << point.percent
+                      << "% do roofline), erro relativo " << relative_error << std::endl;
+            csv_file << variant.kernel << "," << variant.variant << "," << sum_mode_name(mode) << ","
+                     << median_time << "," << bandwidth << "," << std::setprecision(9) << result << ","
+                     << variant.reference << "," << relative_error << std::setprecision(6)
+                     << roofline_csv_columns(point) << perf_csv_columns(counters) << numa_csv_columns() << "\n";
+        }
+    }
+    std::cout << "Resultados salvos em saxpy_reductions.csv" << std::endl;
 }
 
-int main() {
+// Todas as instanciações de axpy<T, isa, unroll> com size elementos, na thread principal
+// e em NUM_THREADS: cada uma é verificada contra a referência e medida pelo harness
+template<typename T>
+void run_axpy_matrix(HarnessCsv& timings, std::ofstream& csv_file, size_t size) {
+    const char* kernel = std::is_same<T, float>::value ? "saxpy" : "daxpy";
+    
+    // Os dados em double são os mesmos floats do Philox, convertidos
+    FloatVector x_float(size);
+    FloatVector y_float(size);
+    generate_data(x_float, y_float);
+    const auto x = first_touch_convert<AlignedVector<T>>(x_float, NUM_THREADS);
+    const auto y = first_touch_convert<AlignedVector<T>>(y_float, NUM_THREADS);
+    const AlignedVector<T> y_expected = axpy_reference<T>(ALPHA, x, y);
+    auto y_run = first_touch_allocate<AlignedVector<T>>(size, NUM_THREADS);
+    
+    const double bytes = 3.0 * sizeof(T) * size;
+    const int batch = static_cast<int>(std::max(1.0, SWEEP_BATCH_BYTES / bytes));
+    HarnessOptions options = harness_options;
+    options.min_time = std::min(options.min_time, MATRIX_MIN_TIME);
+    
+    for_each_kernel_config<T>([&](auto config) {
+        using Config = decltype(config);
+        for (int threads : {0, NUM_THREADS}) {
+            auto run = [&]() { axpy<T, Config::isa, Config::unroll>(ALPHA, x, y_run, threads); };
+            
+            // A primeira chamada, sobre uma cópia nova de y, é a verificada
+            for_each_thread_chunk(size, NUM_THREADS, [&](size_t start, size_t end) {
+                std::copy(y.begin() + start, y.begin() + end, y_run.begin() + start);
+            });
+            run();
+            const VerifyResult verification = verify_buffers(y_expected, y_run, SAXPY_MAX_ULPS, 0.0f, NUM_THREADS);
+            
+            const std::string name = std::string(kernel) + " " + Config::name() + (threads == 0 ? "" : " pool");
+            const int num_threads = std::max(1, threads);
+            PerfRegion region(threads);
+            const TimingStats stats = measure_stats(timings, "matriz", name, size, num_threads, run, options, batch);
+            const PerfSample counters = region.stop(stats.calls());
+            const double seconds = stats.median;
+            const RooflinePoint point =
+                machine_roofline(num_threads).evaluate(SAXPY_FLOPS_PER_ELEMENT * size, bytes, seconds,
+                                                        std::is_same<T, double>::value);
+            
+            std::cout << "  " << name << " (" << num_threads << " thread(s)): " << seconds << "s, "
+                      << size / seconds / 1e9 << " Gelem/s, " << bandwidth_gbs(bytes, seconds) << " GB/s ("
+                      << point.percent << "% do roofline), erro máx " << verification.max_ulp << " ULP"
+                      << (verification.ok() ? "" : " ERRO") << std::endl;
+            csv_file << kernel << "," << type_name<T>() << "," << isa_name(Config::isa) << "," << Config::unroll
+                     << "," << num_threads << "," << (threads == 0 ? 0 : 1) << "," << size << "," << seconds
+                     << "," << size / seconds << "," << bandwidth_gbs(bytes, seconds) << ","
+                     << verification.max_ulp << "," << verification.mismatches << roofline_csv_columns(point) << perf_csv_columns(counters)
+                     << numa_csv_columns() << "\n";
+        }
+    });
+}
+
+// SAXPY e DAXPY em todas as combinações de tipo, conjunto de instruções (até o maior
+// habilitado na compilação), desenrolamento e threads
+void run_matrix_experiment(HarnessCsv& timings) {
+    std::cout << "\n" << std::string(70, '=') << std::endl;
+    std::cout << "MATRIZ DE INSTANCIAÇÕES: {float, double} x {Escalar, SSE, AVX2, AVX-512} x {1, 2, 4}" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    if (!isa_enabled(Isa::AVX512)) {
+        std::cout << "AVX-512 não habilitado na compilação; essas instanciações ficam de fora" << std::endl;
+    }
+    
+    std::ofstream csv_file("saxpy_matrix.csv");
+    csv_file << "Kernel,Tipo,ISA,Desenrolamento,Threads,Pool,Elementos,Tempo(s),Elementos/s,Bandwidth(GB/s),"
+                "ErroMáx(ULP),Divergências" << ROOFLINE_CSV_HEADER << perf_csv_header() << NUMA_CSV_HEADER << "\n";
+    for (size_t size : MATRIX_SIZES) {
+        std::cout << "\n" << size << " elementos:" << std::endl;
+        run_axpy_matrix<float>(timings, csv_file, size);
+        run_axpy_matrix<double>(timings, csv_file, size);
+    }
+    std::cout << "Resultados salvos em saxpy_matrix.csv" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    bool seed_given = false;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--pin") {
+                numa_pin_threads = true;
+            } else if (arg == "--seed" && i + 1 < argc) {
+                data_seed = parse_number<uint64_t>(arg, argv[++i]);
+                seed_given = true;
+            } else if (!parse_harness_option(argc, argv, i) && !parse_sweep_option(argc, argv, i)) {
+                std::cerr << "Uso: " << argv[0] << " [--pin] [--seed N] [--warmup N] [--min-time S] [--sweep-max-mb N]\n"
+                          << "  --pin     fixa cada thread numa CPU do nó NUMA do seu bloco de dados\n"
+                          << "  --seed N  semente dos dados aleatórios (padrão: sorteada)\n"
+                          << HARNESS_USAGE << SWEEP_USAGE << std::flush;
+                return 1;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    } catch (const std::out_of_range& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (!seed_given) {
+        data_seed = random_seed_from_device();
+    }
+    
+    // Todas as medições, no esquema comum do harness
+    HarnessCsv timings("saxpy_timings.csv", "saxpy");
+    
     // Executar experimento principal
-    run_saxpy_experiment();
+    run_saxpy_experiment(timings);
+    
+    // Cadeia de operações fundida
+    run_fused_experiment(timings);
+    
+    // Reduções (sdot, snrm2, sasum)
+    run_reduction_experiment(timings);
+    
+    // x e y guardados em fp16 e bf16
+    run_precision_experiment(timings);
+    
+    // SAXPY e DAXPY em todas as instanciações dos templates
+    run_matrix_experiment(timings);
     
-    // Executar teste de escalabilidade
-    run_scalability_test();
+    // Varredura de working set (L1, L2, LLC e DRAM)
+    run_sweep_experiment(timings);
     
     return 0;
 }
\ No newline at end of file
@@ -128,6 +128,46 @@ def analyze_results(df):
         correlation = df[col].corr(pd.Series(range(len(df))))
         print(f"{col}: {correlation:.3f}")
 
+def analyze_sweep():
+    """Plota a bandwidth por working set da varredura (L1/L2/LLC/DRAM)"""
+    try:
+        df_sweep = pd.read_csv('sqrt_sweep.csv')
+        df_marks = pd.read_csv('sqrt_sweep_marks.csv')
+    except FileNotFoundError:
+        print("Arquivos da varredura não encontrados")
+        return
+    
+    fig, ax = plt.subplots(figsize=(12, 7))
+    for variant, group in df_sweep.groupby('Variante', sort=False):
+        ax.plot(group['WorkingSet(B)'], group['Bandwidth(GB/s)'], '.-', label=variant, linewidth=1.5)
+        ax.fill_between(group['WorkingSet(B)'], group['BandwidthICInf(GB/s)'],
+                        group['BandwidthICSup(GB/s)'], alpha=0.2)
+    
+    # Tamanhos de cache (tracejado) e cruzamentos multi-thread (pontilhado)
+    for _, mark in df_marks.iterrows():
+        if mark['Tipo'] == 'cache':
+            ax.axvline(mark['WorkingSet(B)'], color='gray', linestyle='--', alpha=0.7)
+            ax.text(mark['WorkingSet(B)'], 1.0, f" {mark['Marca']}", color='gray',
+                    transform=ax.get_xaxis_transform(), va='top')
+        else:
+            ax.axvline(mark['WorkingSet(B)'], color='red', linestyle=':', alpha=0.7,
+                       label=f"Cruzamento {mark['Marca']}")
+    
+    ax.set_xlabel('Working set (bytes)')
+    ax.set_ylabel('Bandwidth (GB/s)')
+    ax.set_title('Raiz Quadrada: Bandwidth por Working Set')
+    ax.set_xscale('log', base=2)
+    ax.legend(fontsize=10)
+    ax.grid(True, alpha=0.3)
+    
+    plt.tight_layout()
+    plt.savefig('sqrt_sweep.png', dpi=300, bbox_inches='tight')
+    print("Gráfico da varredura salvo em sqrt_sweep.png")
+    
+    print("\nBandwidth mediana por nível (GB/s):")
+    print(df_sweep.pivot_table(index='Variante', columns='Nível', values='Bandwidth(GB/s)',
+                               aggfunc='median', sort=False).round(2).to_string())
+
 def main():
     """Função principal"""
     print("=== ANÁLISE DE PERFORMANCE DE CÁLCULO DE RAÍZ QUADRADA ===")
@@ -138,6 +178,7 @@ def main():
     if df is not None:
         # Analisar resultados
         analyze_results(df)
+        analyze_sweep()
         
         # Mostrar tabela de resultados
         print("\n=== TABELA DE RESULTADOS ===")
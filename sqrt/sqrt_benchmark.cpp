@@ -1,17 +1,44 @@
 #include <iostream>
 #include <fstream>  // Adicionado este include
 #include <vector>
-#include <random>
+#include <cstdlib>
 #include <chrono>
 #include <thread>
 #include <immintrin.h>
 #include <cmath>
 #include <algorithm>
+#include <string>
+#include <type_traits>
+
+#include "../common/aligned_allocator.h"
+#include "../common/numa.h"
+#include "../common/random.h"
+#include "../common/verify.h"
+#include "../common/roofline.h"
+#include "../common/perf_counters.h"
+#include "../common/benchmark.h"
+#include "../common/sweep.h"
+#include "../common/simd.h"
+
+#ifdef HAVE_ISPC
+#include "sqrt_ispc.h"
+#endif
 
 // Configurações
 const size_t ARRAY_SIZE = 20000000; // 20 milhões
-const int NUM_TRIALS = 10;
 const int NUM_THREADS = std::thread::hardware_concurrency();
+const int DISPATCH_CALLS = 1000; // Chamadas vazias para medir o custo de despacho
+const uint32_t SQRT_MAX_ULPS = 0;  // A raiz IEEE é exata após o arredondamento
+const size_t MATRIX_SIZES[] = {size_t(1) << 14, size_t(1) << 24};
+const double MATRIX_MIN_TIME = 0.1;  // Limite de --min-time por instanciação
+
+// Trabalho por elemento para o roofline: uma raiz (contada como 1 FLOP), lendo a entrada
+// e escrevendo a saída
+const double SQRT_FLOPS_PER_ELEMENT = 1.0;
+const double SQRT_BYTES_PER_ELEMENT = 2.0 * sizeof(float);
+
+// Semente dos dados (--seed); sem a opção é sorteada e impressa para repetir a execução
+uint64_t data_seed = 0;
 
 // Estrutura para resultados
 struct BenchmarkResult {
@@ -22,6 +49,16 @@ struct BenchmarkResult {
     double speedup_simd;
     double speedup_threaded;
     double speedup_simd_threaded;
+    double ispc_time;
+    double ispc_tasks_time;
+    double speedup_ispc;
+    double speedup_ispc_tasks;
+    PerfSample serial_counters;  // Contadores de hardware por chamada de cada versão
+    PerfSample simd_counters;
+    PerfSample threaded_counters;
+    PerfSample simd_threaded_counters;
+    PerfSample ispc_counters;
+    PerfSample ispc_tasks_counters;  // Sempre indisponível: as tarefas do ISPC criam threads próprias
 };
 
 // Gerar array com diferentes distribuições
@@ -33,50 +70,75 @@ enum class DataDistribution {
     SKEWED          // Distribuição assimétrica
 };
 
-std::vector<float> generate_data(DataDistribution distribution, size_t size) {
-    std::vector<float> data(size);
-    std::random_device rd;
-    std::mt19937 gen(rd());
+const char* distribution_name(DataDistribution distribution) {
+    switch (distribution) {
+        case DataDistribution::UNIFORM: return "UNIFORM";
+        case DataDistribution::NORMAL: return "NORMAL";
+        case DataDistribution::EXPONENTIAL: return "EXPONENTIAL";
+        case DataDistribution::SPARSE: return "SPARSE";
+        case DataDistribution::SKEWED: return "SKEWED";
+    }
+    return "";
+}
+
+// Os dados vêm do Philox (um fluxo por distribuição) e são gerados em paralelo com o
+// particionamento das threads de cálculo, o que também faz o first-touch NUMA
+FloatVector generate_data(DataDistribution distribution, size_t size) {
+    FloatVector data(size);
+    const uint32_t stream = static_cast<uint32_t>(distribution);
     
     switch (distribution) {
         case DataDistribution::UNIFORM: {
-            std::uniform_real_distribution<float> dis(0.0f, 1000.0f);
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = dis(gen);
-            }
+            fill_uniform(data, 0.0f, 1000.0f, data_seed, stream, NUM_THREADS);
             break;
         }
         case DataDistribution::NORMAL: {
-            std::normal_distribution<float> dis(500.0f, 200.0f);
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = std::abs(dis(gen)); // Valores positivos
-            }
+            // Box-Muller: |500 + 200 * sqrt(-2 ln u1) * cos(2 pi u2)| (valores positivos)
+            fill_random(data, data_seed, stream, NUM_THREADS, [](const RandomGroup& rng, __m256 out[4]) {
+                __m256 u1[4], u2[4];
+                rng.uniform_open(0, u1);
+                rng.uniform(1, u2);
+                for (int w = 0; w < 4; w++) {
+                    __m256 radius = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), log_ps(u1[w])));
+                    __m256 value = _mm256_fmadd_ps(_mm256_mul_ps(radius, cos_turns_ps(u2[w])),
+                                                   _mm256_set1_ps(200.0f), _mm256_set1_ps(500.0f));
+                    out[w] = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value);
+                }
+            });
             break;
         }
         case DataDistribution::EXPONENTIAL: {
-            std::exponential_distribution<float> dis(0.001f);
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = dis(gen);
-            }
+            // -ln(u) / lambda, lambda = 0.001
+            fill_random(data, data_seed, stream, NUM_THREADS, [](const RandomGroup& rng, __m256 out[4]) {
+                rng.uniform_open(0, out);
+                for (int w = 0; w < 4; w++) {
+                    out[w] = _mm256_mul_ps(log_ps(out[w]), _mm256_set1_ps(-1000.0f));
+                }
+            });
             break;
         }
         case DataDistribution::SPARSE: {
-            std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-            std::uniform_real_distribution<float> high_dis(100.0f, 10000.0f);
-            for (size_t i = 0; i < size; ++i) {
-                if (dis(gen) < 0.01f) { // 1% de valores altos
-                    data[i] = high_dis(gen);
-                } else {
-                    data[i] = 0.0f;
+            // 1% de valores altos em [100, 10000), o resto zero
+            fill_random(data, data_seed, stream, NUM_THREADS, [](const RandomGroup& rng, __m256 out[4]) {
+                __m256 select[4];
+                rng.uniform(0, select);
+                rng.uniform(1, out);
+                for (int w = 0; w < 4; w++) {
+                    __m256 high = _mm256_fmadd_ps(out[w], _mm256_set1_ps(9900.0f), _mm256_set1_ps(100.0f));
+                    out[w] = _mm256_and_ps(_mm256_cmp_ps(select[w], _mm256_set1_ps(0.01f), _CMP_LT_OQ), high);
                 }
-            }
+            });
             break;
         }
         case DataDistribution::SKEWED: {
-            std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-            for (size_t i = 0; i < size; ++i) {
-                data[i] = std::pow(dis(gen), 3.0f) * 1000.0f; // Distribuição assimétrica
-            }
+            // u^3 * 1000: distribuição assimétrica
+            fill_random(data, data_seed, stream, NUM_THREADS, [](const RandomGroup& rng, __m256 out[4]) {
+                rng.uniform(0, out);
+                for (int w = 0; w < 4; w++) {
+                    __m256 cube = _mm256_mul_ps(_mm256_mul_ps(out[w], out[w]), out[w]);
+                    out[w] = _mm256_mul_ps(cube, _mm256_set1_ps(1000.0f));
+                }
+            });
             break;
         }
     }
@@ -84,115 +146,80 @@ std::vector<float> generate_data(DataDistribution distribution, size_t size) {
     return data;
 }
 
-// Versão serial usando std::sqrt
-void sqrt_serial(const std::vector<float>& input, std::vector<float>& output) {
-    for (size_t i = 0; i < input.size(); ++i) {
-        output[i] = std::sqrt(input[i]);
+// Raiz sobre [begin, end) para qualquer tipo, conjunto de instruções e desenrolamento:
+// grupos de Unroll vetores independentes, depois de um vetor, e o resto em escalar
+template<typename T, Isa I, int Unroll = 1>
+void sqrt_range(const T* input, T* output, size_t begin, size_t end) {
+    using S = Simd<T, I>;
+    size_t i = begin;
+    for (; i + S::lanes * Unroll <= end; i += S::lanes * Unroll) {
+        typename S::Vec result[Unroll];
+        for (int u = 0; u < Unroll; u++) result[u] = S::sqrt(S::load(&input[i + u * S::lanes]));
+        for (int u = 0; u < Unroll; u++) S::store(&output[i + u * S::lanes], result[u]);
     }
-}
-
-// Versão SIMD usando instruções AVX
-void sqrt_simd(const std::vector<float>& input, std::vector<float>& output) {
-    const size_t size = input.size();
-    const size_t simd_size = size - (size % 8); // AVX processa 8 floats por vez
-    
-    // Processar blocos de 8 elementos
-    for (size_t i = 0; i < simd_size; i += 8) {
-        __m256 vec = _mm256_loadu_ps(&input[i]);
-        __m256 result = _mm256_sqrt_ps(vec);
-        _mm256_storeu_ps(&output[i], result);
+    for (; i + S::lanes <= end; i += S::lanes) {
+        S::store(&output[i], S::sqrt(S::load(&input[i])));
     }
     
     // Processar elementos restantes serialmente
-    for (size_t i = simd_size; i < size; ++i) {
+    for (; i < end; ++i) {
         output[i] = std::sqrt(input[i]);
     }
 }
 
-// Função para processamento multi-thread
-void sqrt_threaded(const std::vector<float>& input, std::vector<float>& output, int num_threads) {
-    std::vector<std::thread> threads;
-    const size_t chunk_size = input.size() / num_threads;
-    
-    for (int i = 0; i < num_threads; ++i) {
-        size_t start = i * chunk_size;
-        size_t end = (i == num_threads - 1) ? input.size() : start + chunk_size;
-        
-        threads.emplace_back([&, start, end]() {
-            for (size_t j = start; j < end; ++j) {
-                output[j] = std::sqrt(input[j]);
-            }
-        });
-    }
-    
-    for (auto& thread : threads) {
-        thread.join();
+// Raiz da instanciação <T, I, Unroll>. Com num_threads = 0 roda na thread que chama;
+// senão em blocos de thread_chunk no pool, os mesmos do first-touch.
+template<typename T, Isa I, int Unroll = 1>
+void square_root(Slice<const T> input, Slice<T> output, int num_threads = 0) {
+    if (num_threads == 0) {
+        sqrt_range<T, I, Unroll>(input.data(), output.data(), 0, input.size());
+        return;
     }
+    for_each_thread_chunk(input.size(), num_threads, [&](size_t start, size_t end) {
+        sqrt_range<T, I, Unroll>(input.data(), output.data(), start, end);
+    });
+}
+
+// Versão serial usando std::sqrt
+void sqrt_serial(ConstFloatSlice input, FloatSlice output) {
+    square_root<float, Isa::SCALAR>(input, output);
+}
+
+// Versão SIMD usando instruções AVX
+void sqrt_simd(ConstFloatSlice input, FloatSlice output) {
+    square_root<float, Isa::AVX2>(input, output);
+}
+
+// Função para processamento multi-thread (blocos de thread_chunk, os mesmos do first-touch)
+void sqrt_threaded(ConstFloatSlice input, FloatSlice output, int num_threads) {
+    square_root<float, Isa::SCALAR>(input, output, num_threads);
 }
 
 // Versão SIMD + multi-thread
-void sqrt_simd_threaded(const std::vector<float>& input, std::vector<float>& output, int num_threads) {
-    std::vector<std::thread> threads;
-    const size_t chunk_size = (input.size() + num_threads - 1) / num_threads;
-    
-    for (int i = 0; i < num_threads; ++i) {
-        size_t start = i * chunk_size;
-        size_t end = std::min(start + chunk_size, input.size());
-        
-        threads.emplace_back([&, start, end]() {
-            const size_t local_size = end - start;
-            const size_t simd_size = local_size - (local_size % 8);
-            
-            for (size_t j = start; j < start + simd_size; j += 8) {
-                __m256 vec = _mm256_loadu_ps(&input[j]);
-                __m256 result = _mm256_sqrt_ps(vec);
-                _mm256_storeu_ps(&output[j], result);
-            }
-            
-            for (size_t j = start + simd_size; j < end; ++j) {
-                output[j] = std::sqrt(input[j]);
-            }
-        });
-    }
-    
-    for (auto& thread : threads) {
-        thread.join();
-    }
+void sqrt_simd_threaded(ConstFloatSlice input, FloatSlice output, int num_threads) {
+    square_root<float, Isa::AVX2>(input, output, num_threads);
 }
 
-// Medir tempo de execução
-template<typename Func>
-double measure_time(Func func, int num_trials = NUM_TRIALS) {
-    double total_time = 0.0;
-    
-    for (int i = 0; i < num_trials; ++i) {
-        auto start = std::chrono::high_resolution_clock::now();
-        func();
-        auto end = std::chrono::high_resolution_clock::now();
-        total_time += std::chrono::duration<double>(end - start).count();
-    }
-    
-    return total_time / num_trials;
+#ifdef HAVE_ISPC
+// Versão gerada pelo ISPC (foreach)
+void sqrt_ispc(ConstFloatSlice input, FloatSlice output) {
+    ispc::sqrt_ispc(static_cast<int>(input.size()), input.data(), output.data());
 }
 
-// Verificar precisão dos resultados
-double calculate_error(const std::vector<float>& ref, const std::vector<float>& test) {
-    double total_error = 0.0;
-    size_t count = 0;
-    
-    for (size_t i = 0; i < ref.size(); ++i) {
-        if (ref[i] > 0.0f) { // Evitar divisão por zero
-            double error = std::abs(ref[i] - test[i]) / ref[i];
-            total_error += error;
-            count++;
-        }
-    }
-    
-    return (count > 0) ? total_error / count : 0.0;
+// Versão gerada pelo ISPC dividida em tarefas (launch)
+void sqrt_ispc_tasks(ConstFloatSlice input, FloatSlice output, int num_tasks) {
+    ispc::sqrt_ispc_tasks(static_cast<int>(input.size()), input.data(), output.data(), num_tasks);
+}
+#endif
+
+// Posição de uma execução no roofline da máquina com num_threads threads
+RooflinePoint sqrt_roofline(double seconds, int num_threads) {
+    return machine_roofline(num_threads).evaluate(SQRT_FLOPS_PER_ELEMENT * ARRAY_SIZE,
+                                                  SQRT_BYTES_PER_ELEMENT * ARRAY_SIZE, seconds);
 }
 
 // Analisar estatísticas dos dados
-void analyze_data(const std::vector<float>& data, const std::string& name) {
+void analyze_data(const FloatVector& data, const std::string& name) {
     float min_val = *std::min_element(data.begin(), data.end());
     float max_val = *std::max_element(data.begin(), data.end());
     
@@ -212,7 +239,7 @@ void analyze_data(const std::vector<float>& data, const std::string& name) {
     double stddev = std::sqrt(variance);
     
     // Calcular percentis
-    std::vector<float> sorted_data = data;
+    FloatVector sorted_data = data;
     std::sort(sorted_data.begin(), sorted_data.end());
     float p25 = sorted_data[data.size() * 0.25];
     float p50 = sorted_data[data.size() * 0.50];
@@ -235,23 +262,20 @@ void analyze_data(const std::vector<float>& data, const std::string& name) {
 }
 
 // Executar benchmark para uma distribuição específica
-BenchmarkResult run_benchmark(DataDistribution distribution) {
-    std::cout << "Gerando dados com distribuição: ";
-    switch (distribution) {
-        case DataDistribution::UNIFORM: std::cout << "UNIFORM"; break;
-        case DataDistribution::NORMAL: std::cout << "NORMAL"; break;
-        case DataDistribution::EXPONENTIAL: std::cout << "EXPONENTIAL"; break;
-        case DataDistribution::SPARSE: std::cout << "SPARSE"; break;
-        case DataDistribution::SKEWED: std::cout << "SKEWED"; break;
-    }
-    std::cout << std::endl;
+BenchmarkResult run_benchmark(DataDistribution distribution, HarnessCsv& timings) {
+    const std::string name = distribution_name(distribution);
+    std::cout << "Gerando dados com distribuição: " << name << std::endl;
     
+    auto setup_start = std::chrono::high_resolution_clock::now();
     auto input = generate_data(distribution, ARRAY_SIZE);
-    std::vector<float> output_serial(ARRAY_SIZE);
-    std::vector<float> output_simd(ARRAY_SIZE);
-    std::vector<float> output_threaded(ARRAY_SIZE);
-    std::vector<float> output_simd_threaded(ARRAY_SIZE);
-    std::vector<float> output_reference(ARRAY_SIZE);
+    auto setup_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Dados gerados em " << std::chrono::duration<double>(setup_end - setup_start).count()
+              << "s" << std::endl;
+    auto output_serial = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
+    auto output_simd = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
+    auto output_threaded = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
+    auto output_simd_threaded = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
+    auto output_reference = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
     
     BenchmarkResult result;
     
@@ -261,50 +285,243 @@ BenchmarkResult run_benchmark(DataDistribution distribution) {
     
     // Benchmark serial
     std::cout << "Executando versão serial..." << std::endl;
-    result.serial_time = measure_time([&]() {
+    PerfRegion serial_region;
+    const TimingStats serial_stats = measure_stats(timings, name, "Serial", ARRAY_SIZE, 1, [&]() {
         sqrt_serial(input, output_serial);
     });
+    result.serial_time = serial_stats.median;
+    result.serial_counters = serial_region.stop(serial_stats.calls());
     
     // Benchmark SIMD
     std::cout << "Executando versão SIMD..." << std::endl;
-    result.simd_time = measure_time([&]() {
+    PerfRegion simd_region;
+    const TimingStats simd_stats = measure_stats(timings, name, "SIMD", ARRAY_SIZE, 1, [&]() {
         sqrt_simd(input, output_simd);
     });
+    result.simd_time = simd_stats.median;
+    result.simd_counters = simd_region.stop(simd_stats.calls());
     
     // Benchmark multi-thread
     std::cout << "Executando versão multi-thread..." << std::endl;
-    result.threaded_time = measure_time([&]() {
+    PerfRegion threaded_region(NUM_THREADS);
+    const TimingStats threaded_stats = measure_stats(timings, name, "Multi-thread", ARRAY_SIZE, NUM_THREADS, [&]() {
         sqrt_threaded(input, output_threaded, NUM_THREADS);
     });
+    result.threaded_time = threaded_stats.median;
+    result.threaded_counters = threaded_region.stop(threaded_stats.calls());
     
     // Benchmark SIMD + multi-thread
     std::cout << "Executando versão SIMD + multi-thread..." << std::endl;
-    result.simd_threaded_time = measure_time([&]() {
-        sqrt_simd_threaded(input, output_simd_threaded, NUM_THREADS);
+    PerfRegion simd_threaded_region(NUM_THREADS);
+    const TimingStats simd_threaded_stats =
+        measure_stats(timings, name, "SIMD+Multi-thread", ARRAY_SIZE, NUM_THREADS, [&]() {
+            sqrt_simd_threaded(input, output_simd_threaded, NUM_THREADS);
+        });
+    result.simd_threaded_time = simd_threaded_stats.median;
+    result.simd_threaded_counters = simd_threaded_region.stop(simd_threaded_stats.calls());
+    
+#ifdef HAVE_ISPC
+    // Benchmark das versões geradas pelo ISPC
+    auto output_ispc = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
+    auto output_ispc_tasks = first_touch_allocate<FloatVector>(ARRAY_SIZE, NUM_THREADS);
+    
+    std::cout << "Executando versão ISPC..." << std::endl;
+    PerfRegion ispc_region;
+    const TimingStats ispc_stats = measure_stats(timings, name, "ISPC", ARRAY_SIZE, 1, [&]() {
+        sqrt_ispc(input, output_ispc);
     });
+    result.ispc_time = ispc_stats.median;
+    result.ispc_counters = ispc_region.stop(ispc_stats.calls());
+    
+    std::cout << "Executando versão ISPC + tasks..." << std::endl;
+    const TimingStats ispc_tasks_stats = measure_stats(timings, name, "ISPC+tasks", ARRAY_SIZE, NUM_THREADS, [&]() {
+        sqrt_ispc_tasks(input, output_ispc_tasks, NUM_THREADS);
+    });
+    result.ispc_tasks_time = ispc_tasks_stats.median;
+    
+    result.speedup_ispc = result.serial_time / result.ispc_time;
+    result.speedup_ispc_tasks = result.serial_time / result.ispc_tasks_time;
+#endif
     
     // Calcular speedups
     result.speedup_simd = result.serial_time / result.simd_time;
     result.speedup_threaded = result.serial_time / result.threaded_time;
     result.speedup_simd_threaded = result.serial_time / result.simd_threaded_time;
     
-    // Verificar erros
-    double error_simd = calculate_error(output_reference, output_simd);
-    double error_threaded = calculate_error(output_reference, output_threaded);
-    double error_simd_threaded = calculate_error(output_reference, output_simd_threaded);
-    
-    std::cout << "Erro médio SIMD: " << error_simd * 100 << "%" << std::endl;
-    std::cout << "Erro médio multi-thread: " << error_threaded * 100 << "%" << std::endl;
-    std::cout << "Erro médio SIMD+threaded: " << error_simd_threaded * 100 << "%" << std::endl;
+    print_timing_stats("Serial", serial_stats);
+    print_timing_stats("SIMD", simd_stats);
+    print_timing_stats("Multi-thread", threaded_stats);
+    print_timing_stats("SIMD+Multi-thread", simd_threaded_stats);
+#ifdef HAVE_ISPC
+    print_timing_stats("ISPC", ispc_stats);
+    print_timing_stats("ISPC+tasks", ispc_tasks_stats);
+#endif
+    
+    // Verificar contra a referência (std::sqrt e _mm256_sqrt_ps são corretamente arredondados)
+    print_verification("Verificação SIMD",
+                       verify_buffers(output_reference, output_simd, SQRT_MAX_ULPS, 0.0f, NUM_THREADS));
+    print_verification("Verificação multi-thread",
+                       verify_buffers(output_reference, output_threaded, SQRT_MAX_ULPS, 0.0f, NUM_THREADS));
+    print_verification("Verificação SIMD+threaded",
+                       verify_buffers(output_reference, output_simd_threaded, SQRT_MAX_ULPS, 0.0f, NUM_THREADS));
+#ifdef HAVE_ISPC
+    print_verification("Verificação ISPC",
+                       verify_buffers(output_reference, output_ispc, SQRT_MAX_ULPS, 0.0f, NUM_THREADS));
+    print_verification("Verificação ISPC+tasks",
+                       verify_buffers(output_reference, output_ispc_tasks, SQRT_MAX_ULPS, 0.0f, NUM_THREADS));
+#endif
     
     return result;
 }
 
-int main() {
+// Varredura de working set (de 4 KiB até alguns GiB) de todas as versões, com dados
+// UNIFORM: entrada e saída são alocadas uma vez no maior tamanho e fatiadas
+void run_sweep_experiment(HarnessCsv& timings) {
+    std::cout << "\n" << std::string(60, '=') << std::endl;
+    std::cout << "VARREDURA DE WORKING SET (entrada + saída)" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    
+    const size_t max_elements = sweep_limit_bytes() / (2 * sizeof(float));
+    const FloatVector input = generate_data(DataDistribution::UNIFORM, max_elements);
+    auto output = first_touch_allocate<FloatVector>(max_elements, NUM_THREADS);
+    const ConstFloatSlice in = input;
+    const FloatSlice out = output;
+    
+    const std::vector<SweepVariant> variants = {
+        {"Serial", 1, [&](size_t n) { sqrt_serial(in.first(n), out.first(n)); }},
+        {"SIMD", 1, [&](size_t n) { sqrt_simd(in.first(n), out.first(n)); }},
+        {"Multi-thread", NUM_THREADS, [&](size_t n) { sqrt_threaded(in.first(n), out.first(n), NUM_THREADS); }},
+        {"SIMD+Multi-thread", NUM_THREADS,
+         [&](size_t n) { sqrt_simd_threaded(in.first(n), out.first(n), NUM_THREADS); }},
+#ifdef HAVE_ISPC
+        {"ISPC", 1, [&](size_t n) { sqrt_ispc(in.first(n), out.first(n)); }},
+        {"ISPC+tasks", NUM_THREADS, [&](size_t n) { sqrt_ispc_tasks(in.first(n), out.first(n), NUM_THREADS); }},
+#endif
+    };
+    const std::vector<SweepCrossover> crossovers = {
+        {"Serial", "Multi-thread"},
+        {"SIMD", "SIMD+Multi-thread"},
+    };
+    run_working_set_sweep("sqrt", variants, crossovers,
+                          {2 * sizeof(float), SQRT_BYTES_PER_ELEMENT, SQRT_FLOPS_PER_ELEMENT}, max_elements, timings);
+}
+
+// Todas as instanciações de square_root<T, isa, unroll> com size elementos UNIFORM, na
+// thread principal e em NUM_THREADS; a referência é std::sqrt elemento a elemento
+template<typename T>
+void run_sqrt_matrix(HarnessCsv& timings, std::ofstream& csv_file, size_t size) {
+    // Os dados em double são os mesmos floats do Philox, convertidos
+    const auto input = first_touch_convert<AlignedVector<T>>(generate_data(DataDistribution::UNIFORM, size),
+                                                             NUM_THREADS);
+    auto expected = first_touch_allocate<AlignedVector<T>>(size, NUM_THREADS);
+    for_each_thread_chunk(size, NUM_THREADS, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) expected[i] = std::sqrt(input[i]);
+    });
+    auto output = first_touch_allocate<AlignedVector<T>>(size, NUM_THREADS);
+    
+    const double bytes = 2.0 * sizeof(T) * size;
+    const int batch = static_cast<int>(std::max(1.0, SWEEP_BATCH_BYTES / bytes));
+    HarnessOptions options = harness_options;
+    options.min_time = std::min(options.min_time, MATRIX_MIN_TIME);
+    
+    for_each_kernel_config<T>([&](auto config) {
+        using Config = decltype(config);
+        for (int threads : {0, NUM_THREADS}) {
+            auto run = [&]() { square_root<T, Config::isa, Config::unroll>(input, output, threads); };
+            
+            run();
+            const VerifyResult verification = verify_buffers(expected, output, SQRT_MAX_ULPS, 0.0f, NUM_THREADS);
+            
+            const std::string name = std::string("sqrt ") + Config::name() + (threads == 0 ? "" : " pool");
+            const int num_threads = std::max(1, threads);
+            PerfRegion region(threads);
+            const TimingStats stats = measure_stats(timings, "matriz", name, size, num_threads, run, options, batch);
+            const PerfSample counters = region.stop(stats.calls());
+            const double seconds = stats.median;
+            const RooflinePoint point =
+                machine_roofline(num_threads).evaluate(SQRT_FLOPS_PER_ELEMENT * size, bytes, seconds,
+                                                        std::is_same<T, double>::value);
+            
+            std::cout << "  " << name << " (" << num_threads << " thread(s)): " << seconds << "s, "
+                      << size / seconds / 1e9 << " Gelem/s, " << bytes / seconds / 1e9 << " GB/s ("
+                      << point.percent << "% do roofline), erro máx " << verification.max_ulp << " ULP"
+                      << (verification.ok() ? "" : " ERRO") << std::endl;
+            csv_file << type_name<T>() << "," << isa_name(Config::isa) << "," << Config::unroll << ","
+                     << num_threads << "," << (threads == 0 ? 0 : 1) << "," << size << "," << seconds << ","
+                     << size / seconds << "," << bytes / seconds / 1e9 << "," << verification.max_ulp << ","
+                     << verification.mismatches << roofline_csv_columns(point) << perf_csv_columns(counters)
+                     << numa_csv_columns() << "\n";
+        }
+    });
+}
+
+// Raiz em float e double em todas as combinações de conjunto de instruções (até o maior
+// habilitado na compilação), desenrolamento e threads
+void run_matrix_experiment(HarnessCsv& timings) {
+    std::cout << "\n" << std::string(60, '=') << std::endl;
+    std::cout << "MATRIZ DE INSTANCIAÇÕES: {float, double} x {Escalar, SSE, AVX2, AVX-512} x {1, 2, 4}" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    if (!isa_enabled(Isa::AVX512)) {
+        std::cout << "AVX-512 não habilitado na compilação; essas instanciações ficam de fora" << std::endl;
+    }
+    
+    std::ofstream csv_file("sqrt_matrix.csv");
+    csv_file << "Tipo,ISA,Desenrolamento,Threads,Pool,Elementos,Tempo(s),Elementos/s,Bandwidth(GB/s),"
+                "ErroMáx(ULP),Divergências" << ROOFLINE_CSV_HEADER << perf_csv_header() << NUMA_CSV_HEADER << "\n";
+    for (size_t size : MATRIX_SIZES) {
+        std::cout << "\n" << size << " elementos:" << std::endl;
+        run_sqrt_matrix<float>(timings, csv_file, size);
+        run_sqrt_matrix<double>(timings, csv_file, size);
+    }
+    std::cout << "Resultados salvos em sqrt_matrix.csv" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    bool seed_given = false;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--pin") {
+                numa_pin_threads = true;
+            } else if (arg == "--seed" && i + 1 < argc) {
+                data_seed = parse_number<uint64_t>(arg, argv[++i]);
+                seed_given = true;
+            } else if (!parse_harness_option(argc, argv, i) && !parse_sweep_option(argc, argv, i)) {
+                std::cerr << "Uso: " << argv[0] << " [--pin] [--seed N] [--warmup N] [--min-time S] [--sweep-max-mb N]\n"
+                          << "  --pin     fixa cada thread numa CPU do nó NUMA do seu bloco de dados\n"
+                          << "  --seed N  semente dos dados aleatórios (padrão: sorteada)\n"
+                          << HARNESS_USAGE << SWEEP_USAGE << std::flush;
+                return 1;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    } catch (const std::out_of_range& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (!seed_given) {
+        data_seed = random_seed_from_device();
+    }
+    
     std::cout << "=== BENCHMARK DE CÁLCULO DE RAÍZ QUADRADA ===" << std::endl;
     std::cout << "Tamanho do array: " << ARRAY_SIZE << " elementos" << std::endl;
     std::cout << "Número de threads: " << NUM_THREADS << std::endl;
-    std::cout << "Número de trials: " << NUM_TRIALS << std::endl;
+    std::cout << "Medição: " << harness_options.warmup_runs << " aquecimento(s), pelo menos "
+              << harness_options.min_runs << " execuções e " << harness_options.min_time << " s por versão"
+              << std::endl;
+    std::cout << "Topologia NUMA: " << numa_topology().num_nodes() << " nó(s) ("
+              << describe_numa_topology(numa_topology()) << "), afinidade de threads: "
+              << (numa_pin_threads ? "fixa" : "livre") << std::endl;
+    std::cout << "Semente: " << data_seed << std::endl;
+    
+    double dispatch_pool, dispatch_spawn;
+    measure_dispatch_overhead(NUM_THREADS, DISPATCH_CALLS, dispatch_pool, dispatch_spawn);
+    std::cout << "Custo de despacho (parallel_for vazio): pool " << dispatch_pool * 1e6
+              << " us, threads por chamada " << dispatch_spawn * 1e6 << " us" << std::endl;
+    print_roofline(machine_roofline(1));
+    if (NUM_THREADS != 1) print_roofline(machine_roofline(NUM_THREADS));
     
     // Gerar dados para análise
     std::vector<DataDistribution> distributions = {
@@ -320,6 +537,7 @@ int main() {
     };
     
     std::vector<BenchmarkResult> results;
+    HarnessCsv timings("sqrt_timings.csv", "sqrt");  // Todas as medições, no esquema comum do harness
     
     // Analisar estatísticas de cada distribuição
     for (int i = 0; i < distributions.size(); ++i) {
@@ -333,7 +551,7 @@ int main() {
         std::cout << "BENCHMARK PARA DISTRIBUIÇÃO: " << dist_names[i] << std::endl;
         std::cout << std::string(60, '=') << std::endl;
         
-        auto result = run_benchmark(distributions[i]);
+        auto result = run_benchmark(distributions[i], timings);
         results.push_back(result);
         
         std::cout << "\nRESULTADOS:" << std::endl;
@@ -344,12 +562,40 @@ int main() {
         std::cout << "Speedup SIMD: " << result.speedup_simd << "x" << std::endl;
         std::cout << "Speedup multi-thread: " << result.speedup_threaded << "x" << std::endl;
         std::cout << "Speedup SIMD+multi-thread: " << result.speedup_simd_threaded << "x" << std::endl;
+        print_roofline_point("Roofline serial", sqrt_roofline(result.serial_time, 1));
+        print_roofline_point("Roofline SIMD", sqrt_roofline(result.simd_time, 1));
+        print_roofline_point("Roofline multi-thread", sqrt_roofline(result.threaded_time, NUM_THREADS));
+        print_roofline_point("Roofline SIMD+multi-thread", sqrt_roofline(result.simd_threaded_time, NUM_THREADS));
+        print_perf_sample("Contadores serial", result.serial_counters);
+        print_perf_sample("Contadores SIMD", result.simd_counters);
+        print_perf_sample("Contadores multi-thread", result.threaded_counters);
+        print_perf_sample("Contadores SIMD+multi-thread", result.simd_threaded_counters);
+#ifdef HAVE_ISPC
+        std::cout << "Tempo ISPC: " << result.ispc_time << "s" << std::endl;
+        std::cout << "Tempo ISPC+tasks: " << result.ispc_tasks_time << "s" << std::endl;
+        std::cout << "Speedup ISPC: " << result.speedup_ispc << "x" << std::endl;
+        std::cout << "Speedup ISPC+tasks: " << result.speedup_ispc_tasks << "x" << std::endl;
+#endif
     }
     
     // Salvar resultados em CSV
     std::ofstream csv_file("sqrt_benchmark_results.csv");
     csv_file << "Distribution,SerialTime,SimdTime,ThreadedTime,SimdThreadedTime,"
-             << "SpeedupSimd,SpeedupThreaded,SpeedupSimdThreaded\n";
+             << "SpeedupSimd,SpeedupThreaded,SpeedupSimdThreaded";
+#ifdef HAVE_ISPC
+    csv_file << ",IspcTime,IspcTasksTime,SpeedupIspc,SpeedupIspcTasks";
+#endif
+    csv_file << ",DispatchPoolUs,DispatchSpawnUs,Intensidade(FLOP/B),SerialRoofline(%),SimdRoofline(%),"
+             << "ThreadedRoofline(%),SimdThreadedRoofline(%)";
+#ifdef HAVE_ISPC
+    csv_file << ",IspcRoofline(%),IspcTasksRoofline(%)";
+#endif
+    csv_file << perf_csv_header("Serial") << perf_csv_header("Simd") << perf_csv_header("Threaded")
+             << perf_csv_header("SimdThreaded");
+#ifdef HAVE_ISPC
+    csv_file << perf_csv_header("Ispc") << perf_csv_header("IspcTasks");
+#endif
+    csv_file << NUMA_CSV_HEADER << "\n";
     
     for (int i = 0; i < results.size(); ++i) {
         csv_file << dist_names[i] << ","
@@ -359,11 +605,37 @@ int main() {
                  << results[i].simd_threaded_time << ","
                  << results[i].speedup_simd << ","
                  << results[i].speedup_threaded << ","
-                 << results[i].speedup_simd_threaded << "\n";
+                 << results[i].speedup_simd_threaded;
+#ifdef HAVE_ISPC
+        csv_file << "," << results[i].ispc_time
+                 << "," << results[i].ispc_tasks_time
+                 << "," << results[i].speedup_ispc
+                 << "," << results[i].speedup_ispc_tasks;
+#endif
+        csv_file << "," << dispatch_pool * 1e6 << "," << dispatch_spawn * 1e6
+                 << "," << SQRT_FLOPS_PER_ELEMENT / SQRT_BYTES_PER_ELEMENT
+                 << "," << sqrt_roofline(results[i].serial_time, 1).percent
+                 << "," << sqrt_roofline(results[i].simd_time, 1).percent
+                 << "," << sqrt_roofline(results[i].threaded_time, NUM_THREADS).percent
+                 << "," << sqrt_roofline(results[i].simd_threaded_time, NUM_THREADS).percent;
+#ifdef HAVE_ISPC
+        csv_file << "," << sqrt_roofline(results[i].ispc_time, 1).percent
+                 << "," << sqrt_roofline(results[i].ispc_tasks_time, NUM_THREADS).percent;
+#endif
+        csv_file << perf_csv_columns(results[i].serial_counters) << perf_csv_columns(results[i].simd_counters)
+                 << perf_csv_columns(results[i].threaded_counters)
+                 << perf_csv_columns(results[i].simd_threaded_counters);
+#ifdef HAVE_ISPC
+        csv_file << perf_csv_columns(results[i].ispc_counters) << perf_csv_columns(results[i].ispc_tasks_counters);
+#endif
+        csv_file << numa_csv_columns() << "\n";
     }
     
     csv_file.close();
     std::cout << "\nResultados salvos em sqrt_benchmark_results.csv" << std::endl;
     
+    run_sweep_experiment(timings);
+    run_matrix_experiment(timings);
+    
     return 0;
 }
\ No newline at end of file